@@ -0,0 +1,111 @@
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define ARENA_MIN_BLOCK 4096
+#define ARENA_ALIGN 16
+
+struct ArenaBlock
+{
+    ArenaBlock *next;
+    size_t used;
+    size_t capacity;
+    _Alignas(ARENA_ALIGN) unsigned char data[];
+};
+
+atomic_size_t alloc_count = 0;
+
+void *counted_malloc(size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    return malloc(size);
+}
+
+void *counted_realloc(void *ptr, size_t size)
+{
+    atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+    return realloc(ptr, size);
+}
+
+// Reserva 'size' bytes na arena. Só chama malloc quando nenhum bloco
+// existente tem espaço; novos blocos crescem geometricamente.
+void *arena_alloc(Arena *arena, size_t size)
+{
+    size = (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+
+    ArenaBlock *block = arena->head;
+    ArenaBlock *last = block;
+    while (block != NULL && block->used + size > block->capacity)
+    {
+        last = block;
+        block = block->next;
+        if (block != NULL)
+        {
+            block->used = 0;
+        }
+    }
+
+    if (block == NULL)
+    {
+        size_t capacity = ARENA_MIN_BLOCK;
+        if (last != NULL && last->capacity * 2 > capacity)
+        {
+            capacity = last->capacity * 2;
+        }
+        if (size > capacity)
+        {
+            capacity = size;
+        }
+
+        block = counted_malloc(sizeof(ArenaBlock) + capacity);
+        if (block == NULL)
+        {
+            return NULL;
+        }
+        block->next = NULL;
+        block->used = 0;
+        block->capacity = capacity;
+
+        if (last != NULL)
+        {
+            // Mantém a ordem da lista: o novo bloco vai para o final
+            while (last->next != NULL)
+            {
+                last = last->next;
+            }
+            last->next = block;
+        }
+        else
+        {
+            arena->first = block;
+        }
+    }
+
+    arena->head = block;
+    void *ptr = block->data + block->used;
+    block->used += size;
+    return ptr;
+}
+
+// Descarta todas as alocações em O(1), mantendo os blocos para reuso
+void arena_reset(Arena *arena)
+{
+    arena->head = arena->first;
+    if (arena->head != NULL)
+    {
+        arena->head->used = 0;
+    }
+}
+
+void arena_free(Arena *arena)
+{
+    ArenaBlock *block = arena->first;
+    while (block != NULL)
+    {
+        ArenaBlock *next = block->next;
+        free(block);
+        block = next;
+    }
+    arena->head = NULL;
+    arena->first = NULL;
+}
@@ -0,0 +1,29 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+
+// Arena de alocação sequencial (bump pointer). Os blocos são mantidos entre
+// usos: arena_reset libera tudo em O(1) e as próximas alocações reaproveitam
+// a memória já obtida, sem novas chamadas a malloc.
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct
+{
+    ArenaBlock *head;    // bloco em uso
+    ArenaBlock *first;   // primeiro bloco da lista (do mais antigo ao mais recente)
+} Arena;
+
+// Número de chamadas a malloc/realloc feitas pelo analisador (arena, tokens);
+// atômico porque vários contextos podem alocar ao mesmo tempo
+extern atomic_size_t alloc_count;
+
+void *counted_malloc(size_t size);
+void *counted_realloc(void *ptr, size_t size);
+
+void *arena_alloc(Arena *arena, size_t size);
+void arena_reset(Arena *arena);
+void arena_free(Arena *arena);
+
+#endif
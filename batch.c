@@ -0,0 +1,508 @@
+#include "batch.h"
+#include "cache.h"
+#include "parser.h"
+#include "source.h"
+#include <dirent.h>
+#include <errno.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// Resultado de um arquivo do lote
+typedef struct
+{
+    char *path;
+    int status; // ParseStatus, ou -1 se o arquivo não pôde ser analisado
+    char message[160];
+    uint64_t hash;   // chave no cache de resultados
+    uint64_t length;
+    size_t tokens;
+    int from_cache;
+} BatchItem;
+
+// Fila de trabalho de uma thread: intervalo [início, fim) de índices em
+// items[], empacotado em 64 bits para ser alterado com uma única CAS. A dona
+// consome pelo início; as outras threads roubam metade pelo fim.
+typedef struct
+{
+    _Atomic uint64_t range;
+    char padding[64 - sizeof(uint64_t)]; // evita falso compartilhamento
+} WorkQueue;
+
+typedef struct
+{
+    BatchItem *items;
+    WorkQueue *queues;
+    int num_workers;
+    const ResultCache *cache; // somente leitura durante a execução, ou NULL
+} Batch;
+
+typedef struct
+{
+    Batch *batch;
+    int id;
+    size_t bytes;
+    size_t tokens;
+    size_t hits;
+    size_t misses;
+    ParserStats stats; // contadores do contexto da thread (com -DPARSER_STATS)
+} Worker;
+
+#define RANGE(begin, end) (((uint64_t)(begin) << 32) | (uint32_t)(end))
+#define RANGE_BEGIN(r) ((uint32_t)((r) >> 32))
+#define RANGE_END(r) ((uint32_t)(r))
+
+// Retira o próximo índice da própria fila, ou -1 se ela estiver vazia
+static long take_own(WorkQueue *q)
+{
+    uint64_t r = atomic_load(&q->range);
+    while (RANGE_BEGIN(r) < RANGE_END(r))
+    {
+        if (atomic_compare_exchange_weak(&q->range, &r, RANGE(RANGE_BEGIN(r) + 1, RANGE_END(r))))
+        {
+            return RANGE_BEGIN(r);
+        }
+    }
+    return -1;
+}
+
+// Rouba metade da fila de outra thread; devolve um índice e guarda o resto na
+// própria fila (que está vazia). Retorna -1 se todas as filas estiverem vazias.
+static long steal(Batch *b, int self)
+{
+    for (int k = 1; k < b->num_workers; k++)
+    {
+        WorkQueue *victim = &b->queues[(self + k) % b->num_workers];
+        uint64_t r = atomic_load(&victim->range);
+        while (RANGE_BEGIN(r) < RANGE_END(r))
+        {
+            uint32_t begin = RANGE_BEGIN(r), end = RANGE_END(r);
+            uint32_t half = (end - begin + 1) / 2;
+            if (atomic_compare_exchange_weak(&victim->range, &r, RANGE(begin, end - half)))
+            {
+                atomic_store(&b->queues[self].range, RANGE(end - half + 1, end));
+                return end - half;
+            }
+        }
+    }
+    return -1;
+}
+
+// Procura o conteúdo no cache; retorna 1 se o resultado veio de lá
+static int lookup_cached(const ResultCache *cache, Worker *w, BatchItem *item, const SourceFile *source)
+{
+    item->hash = cache_hash(source->data, source->len);
+    item->length = source->len;
+    const CacheEntry *entry = cache_find(cache, item->hash, item->length);
+    if (entry == NULL)
+    {
+        w->misses++;
+        return 0;
+    }
+    item->status = entry->status;
+    snprintf(item->message, sizeof(item->message), "%s", entry->message);
+    item->tokens = entry->tokens;
+    item->from_cache = 1;
+    w->hits++;
+    return 1;
+}
+
+static void validate_file(Parser *parser, Worker *w, BatchItem *item)
+{
+    SourceFile source;
+    if (source_open(&source, item->path) != 0)
+    {
+        item->status = -1;
+        snprintf(item->message, sizeof(item->message), "Erro ao abrir o arquivo: %s", strerror(errno));
+        return;
+    }
+
+    const ResultCache *cache = w->batch->cache;
+    if (cache != NULL && lookup_cached(cache, w, item, &source))
+    {
+        w->tokens += item->tokens;
+        w->bytes += source.len;
+        source_close(&source);
+        return;
+    }
+
+    size_t len;
+    if (!source_ends_with_marker(&source, &len))
+    {
+        item->status = PARSE_NO_END_MARKER;
+        snprintf(item->message, sizeof(item->message), "Erro: A entrada deve terminar com '$'.");
+    }
+    else
+    {
+        item->status = parser_parse_buffer(parser, source.data, len);
+        parser_message(parser, item->message, sizeof(item->message));
+        item->tokens = parser_token_count(parser);
+        w->tokens += item->tokens;
+    }
+    w->bytes += source.len;
+    source_close(&source);
+}
+
+static void *worker_main(void *arg)
+{
+    Worker *w = arg;
+    Batch *b = w->batch;
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+
+    while (1)
+    {
+        long i = take_own(&b->queues[w->id]);
+        if (i < 0)
+        {
+            i = steal(b, w->id);
+        }
+        if (i < 0)
+        {
+            break;
+        }
+        validate_file(parser, w, &b->items[i]);
+    }
+
+    w->stats = *parser_stats(parser);
+    parser_destroy(parser);
+    return NULL;
+}
+
+typedef struct
+{
+    BatchItem *items;
+    size_t count;
+    size_t capacity;
+} ItemList;
+
+static int add_path(ItemList *list, const char *path)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 256;
+        BatchItem *items = realloc(list->items, capacity * sizeof(BatchItem));
+        if (items == NULL)
+        {
+            return -1;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    BatchItem *item = &list->items[list->count];
+    item->path = strdup(path);
+    if (item->path == NULL)
+    {
+        return -1;
+    }
+    item->status = -1;
+    item->message[0] = '\0';
+    item->tokens = 0;
+    item->from_cache = 0;
+    list->count++;
+    return 0;
+}
+
+static void free_items(ItemList *list)
+{
+    for (size_t i = 0; i < list->count; i++)
+    {
+        free(list->items[i].path);
+    }
+    free(list->items);
+}
+
+static int compare_items(const void *a, const void *b)
+{
+    return strcmp(((const BatchItem *)a)->path, ((const BatchItem *)b)->path);
+}
+
+// Adiciona o arquivo ou, se for um diretório, todos os arquivos abaixo dele
+// (em ordem alfabética dentro de cada diretório). Um link para diretório só
+// é seguido quando vem da linha de comando (top): dentro da árvore ele é
+// ignorado, o que evita ciclos e arquivos contados duas vezes
+static int collect(ItemList *list, const char *path, int top)
+{
+    struct stat st;
+    if (stat(path, &st) != 0 || !S_ISDIR(st.st_mode))
+    {
+        return add_path(list, path);
+    }
+    struct stat link;
+    if (!top && lstat(path, &link) == 0 && S_ISLNK(link.st_mode))
+    {
+        return 0;
+    }
+
+    DIR *dir = opendir(path);
+    if (dir == NULL)
+    {
+        return add_path(list, path);
+    }
+
+    size_t first = list->count;
+    struct dirent *entry;
+    int status = 0;
+    while (status == 0 && (entry = readdir(dir)) != NULL)
+    {
+        if (entry->d_name[0] == '.')
+        {
+            continue;
+        }
+        size_t n = strlen(path) + strlen(entry->d_name) + 2;
+        char *child = malloc(n);
+        if (child == NULL)
+        {
+            status = -1;
+            break;
+        }
+        snprintf(child, n, "%s/%s", path, entry->d_name);
+        status = collect(list, child, 0);
+        free(child);
+    }
+    closedir(dir);
+
+    qsort(list->items + first, list->count - first, sizeof(BatchItem), compare_items);
+    return status;
+}
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Resultados que só dependem do conteúdo (não de erros de E/S ou de memória)
+static int is_cacheable(const BatchItem *item)
+{
+    return item->status == PARSE_ACCEPTED || item->status == PARSE_SYNTAX_ERROR ||
+           item->status == PARSE_NO_END_MARKER;
+}
+
+// Acrescenta ao cache os resultados calculados nesta execução e o grava
+static void update_cache(ResultCache *cache, const char *path, const ItemList *list)
+{
+    int status = 0;
+    for (size_t i = 0; status == 0 && i < list->count; i++)
+    {
+        const BatchItem *item = &list->items[i];
+        if (!item->from_cache && is_cacheable(item))
+        {
+            status = cache_add(cache, item->hash, item->length, item->tokens, item->status, item->message);
+        }
+    }
+    if (status != 0 || cache_save(cache, path) != 0)
+    {
+        printf("Aviso: Não foi possível gravar o cache '%s'.\n", path);
+    }
+}
+
+int run_batch(int argc, char *argv[])
+{
+    long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    ItemList list = {0};
+    int from_args = 0;
+    const char *cache_path = NULL;
+    const char *stats_path = NULL;
+
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            num_workers = atol(argv[++i]);
+            continue;
+        }
+        if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            cache_path = argv[++i];
+            continue;
+        }
+        if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            stats_path = argv[++i];
+            continue;
+        }
+        from_args = 1;
+        if (collect(&list, argv[i], 1) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            free_items(&list);
+            return 1;
+        }
+    }
+
+    // Sem caminhos na linha de comando: lê a lista da entrada padrão, um por linha
+    if (!from_args)
+    {
+        char *line = NULL;
+        size_t cap = 0;
+        ssize_t n;
+        while ((n = getline(&line, &cap, stdin)) > 0)
+        {
+            while (n > 0 && (line[n - 1] == '\n' || line[n - 1] == '\r'))
+            {
+                line[--n] = '\0';
+            }
+            if (n > 0 && collect(&list, line, 1) != 0)
+            {
+                printf("Erro: Falha ao alocar memória!\n");
+                free(line);
+                free_items(&list);
+                return 1;
+            }
+        }
+        free(line);
+    }
+
+    if (num_workers < 1)
+    {
+        num_workers = 1;
+    }
+    if ((size_t)num_workers > list.count && list.count > 0)
+    {
+        num_workers = (long)list.count;
+    }
+    if (list.count > UINT32_MAX)
+    {
+        printf("Erro: Arquivos demais para um único lote.\n");
+        free_items(&list);
+        return 1;
+    }
+
+    ResultCache cache;
+    if (cache_path != NULL)
+    {
+        int loaded = cache_load(&cache, cache_path);
+        if (loaded < 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            free_items(&list);
+            return 1;
+        }
+        if (loaded > 0)
+        {
+            printf("Aviso: Cache '%s' de outra versão ou corrompido; será recriado.\n", cache_path);
+        }
+    }
+
+    Batch batch = {list.items, NULL, (int)num_workers, cache_path != NULL ? &cache : NULL};
+    batch.queues = aligned_alloc(64, sizeof(WorkQueue) * (size_t)num_workers);
+    Worker *workers = calloc((size_t)num_workers, sizeof(Worker));
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)num_workers);
+    char *started = calloc((size_t)num_workers, 1);
+    if (batch.queues == NULL || workers == NULL || threads == NULL || started == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        if (cache_path != NULL)
+        {
+            cache_free(&cache);
+        }
+        free_items(&list);
+        free(batch.queues);
+        free(workers);
+        free(threads);
+        free(started);
+        return 1;
+    }
+
+    // Distribuição inicial em blocos contíguos; o roubo equilibra o resto
+    for (long i = 0; i < num_workers; i++)
+    {
+        size_t begin = list.count * (size_t)i / (size_t)num_workers;
+        size_t end = list.count * (size_t)(i + 1) / (size_t)num_workers;
+        atomic_init(&batch.queues[i].range, RANGE(begin, end));
+        workers[i].batch = &batch;
+        workers[i].id = (int)i;
+    }
+
+    // A thread que chamou é o worker 0; a fila de uma thread que não pôde ser
+    // criada é esvaziada aqui no fim (se o roubo ainda não a esvaziou)
+    double t0 = now_seconds();
+    long running = 1;
+    for (long i = 1; i < num_workers; i++)
+    {
+        started[i] = pthread_create(&threads[i], NULL, worker_main, &workers[i]) == 0;
+        running += started[i];
+    }
+    worker_main(&workers[0]);
+    for (long i = 1; i < num_workers; i++)
+    {
+        if (started[i])
+        {
+            pthread_join(threads[i], NULL);
+        }
+        else
+        {
+            worker_main(&workers[i]);
+        }
+    }
+    double elapsed = now_seconds() - t0;
+
+    if (cache_path != NULL)
+    {
+        update_cache(&cache, cache_path, &list);
+    }
+
+    size_t accepted = 0, rejected = 0, failed = 0, bytes = 0, tokens = 0, hits = 0, misses = 0;
+    ParserStats stats;
+    memset(&stats, 0, sizeof(stats));
+    for (size_t i = 0; i < list.count; i++)
+    {
+        BatchItem *item = &list.items[i];
+        if (item->status == PARSE_ACCEPTED)
+        {
+            accepted++;
+            printf("ACEITO %s\n", item->path);
+        }
+        else if (item->status == PARSE_SYNTAX_ERROR || item->status == PARSE_NO_END_MARKER)
+        {
+            rejected++;
+            printf("REJEITADO %s: %s\n", item->path, item->message);
+        }
+        else
+        {
+            failed++;
+            printf("ERRO %s: %s\n", item->path, item->message);
+        }
+        free(item->path);
+    }
+    for (long i = 0; i < num_workers; i++)
+    {
+        bytes += workers[i].bytes;
+        tokens += workers[i].tokens;
+        hits += workers[i].hits;
+        misses += workers[i].misses;
+        parser_stats_add(&stats, &workers[i].stats);
+    }
+
+    printf("Total: %zu arquivos (%zu aceitos, %zu rejeitados, %zu com erro), %zu bytes, %zu tokens\n",
+           list.count, accepted, rejected, failed, bytes, tokens);
+    // Sem arquivos não há vazão a medir (e elapsed pode ser zero)
+    if (list.count > 0)
+    {
+        printf("Tempo: %.3f s com %ld threads: %.0f arquivos/s, %.2f MB/s, %.2f Mtokens/s\n", elapsed, running,
+               list.count / elapsed, bytes / elapsed / 1e6, tokens / elapsed / 1e6);
+    }
+    if (cache_path != NULL)
+    {
+        printf("Cache: %zu acertos, %zu faltas\n", hits, misses);
+        cache_free(&cache);
+    }
+    if (stats_path != NULL && parser_stats_save(&stats, stats_path) != 0)
+    {
+        perror("Erro ao gravar as métricas");
+    }
+
+    free(list.items);
+    free(batch.queues);
+    free(workers);
+    free(threads);
+    free(started);
+    return (rejected || failed) ? 2 : 0;
+}
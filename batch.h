@@ -0,0 +1,10 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// Modo lote: valida muitos arquivos em um pool de threads com roubo de trabalho.
+// Com -c, reaproveita os resultados de arquivos inalterados (cache.h); com -m,
+// grava a soma dos contadores dos parsers em JSON (ParserStats).
+// argv contém as opções e os caminhos (arquivos ou diretórios) após "--batch".
+int run_batch(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,1117 @@
+#include "parser.h"
+#include "lexer.h"
+#include "arena.h"
+#include "incremental.h"
+#include "parser_direct.h"
+#include "source.h"
+#include "split.h"
+#include <ctype.h>
+#include <sys/resource.h>
+#include <time.h>
+#include <unistd.h>
+
+// Benchmark do analisador: mede lexer e parse sobre um arquivo, sem trace,
+// e conta as chamadas a malloc/realloc feitas em cada fase.
+// Com --lookup, compara as buscas de símbolos por nome (linear x hash perfeito).
+// Com --lexer, compara o lexer original (ctype, um byte por vez) com a
+// classificação em blocos (escalar, SSE2, AVX2), e o lexer paralelo com o
+// serial (diferencial sobre o arquivo e sobre textos aleatórios).
+// Com --incremental, aplica edições aleatórias a um documento e compara a
+// reanálise incremental com a análise completa do texto.
+// Com --direct, compara o motor gerado (parser_direct.c) com o laço
+// interpretado: mesmos resultados sobre o arquivo e sobre variações dele, e a
+// vazão de cada um. Deve ser compilado sem -DPARSER_DIRECT.
+// Com --split, compara o modo dividido (split.c) com a análise sequencial.
+// Com --phases, mede cada fase de uma execução (leitura, lexer, criação do
+// contexto, parse) e imprime uma linha JSON, para comparar execuções.
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Implementações lineares originais, usadas como referência no --lookup
+static int linear_terminal_index(const char *symbol)
+{
+    for (int i = 0; i < MAX_TERMINALS; i++)
+    {
+        if (strcmp(terminals[i], symbol) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int linear_nonterminal_index(const char *symbol)
+{
+    for (int i = 0; i < MAX_NONTERMINALS; i++)
+    {
+        if (strcmp(nonTerminals[i], symbol) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int linear_is_reserved_word(const char *word)
+{
+    const char *reserved[] = {"int", "if", "else", "def", "print", "return"};
+    for (int i = 0; i < 6; i++)
+    {
+        if (strcmp(word, reserved[i]) == 0)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Compara as buscas lineares com o hash perfeito sobre a mistura de tokens do
+// arquivo: palavras do fonte (palavra reservada?), nomes dos terminais de cada
+// token e nomes dos não-terminais das produções aplicadas.
+static void bench_lookup(const char *src, const TokenArray *tokens, int iterations)
+{
+    size_t n = tokens->count;
+    const char **words = malloc(n * sizeof(char *));
+    size_t *word_lens = malloc(n * sizeof(size_t));
+    const char **term_names = malloc(n * sizeof(char *));
+    size_t src_len = n ? tokens->tokens[n - 1].offset + tokens->tokens[n - 1].length : 0;
+    char *word_buf = malloc(src_len + n + 1);
+    if (!words || !word_lens || !term_names || !word_buf)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+
+    size_t nwords = 0, nterms = 0, used = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        const Token *tk = &tokens->tokens[i];
+        if (isalpha((unsigned char)src[tk->offset]))
+        {
+            memcpy(word_buf + used, src + tk->offset, tk->length);
+            word_buf[used + tk->length] = '\0';
+            words[nwords] = word_buf + used;
+            word_lens[nwords++] = tk->length;
+            used += tk->length + 1;
+        }
+        if (tk->type != T_INVALID)
+        {
+            term_names[nterms++] = terminals[tk->type];
+        }
+    }
+
+    volatile long sink = 0;
+    double t_linear[3], t_hash[3];
+
+    double t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nwords; i++)
+            sink += linear_is_reserved_word(words[i]);
+    t_linear[0] = now_seconds() - t0;
+    t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nwords; i++)
+            sink += reserved_word_type(words[i], word_lens[i]);
+    t_hash[0] = now_seconds() - t0;
+
+    t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nterms; i++)
+            sink += linear_terminal_index(term_names[i]);
+    t_linear[1] = now_seconds() - t0;
+    t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nterms; i++)
+            sink += getTerminalIndex(term_names[i]);
+    t_hash[1] = now_seconds() - t0;
+
+    // Não-terminais na proporção em que aparecem no lado esquerdo das produções
+    size_t nnts = (size_t)num_productions;
+    t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nnts; i++)
+            sink += linear_nonterminal_index(nonTerminals[productions[i].lhs]);
+    t_linear[2] = now_seconds() - t0;
+    t0 = now_seconds();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < nnts; i++)
+            sink += getNonTerminalIndex(nonTerminals[productions[i].lhs]);
+    t_hash[2] = now_seconds() - t0;
+
+    const char *labels[3] = {"palavra reservada", "terminal", "nao-terminal"};
+    size_t counts[3] = {nwords, nterms, nnts};
+    printf("busca (%d iteracoes)   linear ns/op   hash ns/op   ganho\n", iterations);
+    for (int k = 0; k < 3; k++)
+    {
+        double ops = (double)counts[k] * iterations;
+        if (ops == 0)
+        {
+            continue;
+        }
+        printf("%-20s %14.2f %12.2f %6.1fx\n", labels[k], t_linear[k] / ops * 1e9, t_hash[k] / ops * 1e9,
+               t_hash[k] > 0 ? t_linear[k] / t_hash[k] : 0.0);
+    }
+
+    free(words);
+    free(word_lens);
+    free(term_names);
+    free(word_buf);
+}
+
+// Lexer original, byte a byte com ctype, usado como referência no --lexer
+static int reference_tokenize(const char *src, size_t len, TokenArray *out)
+{
+    out->count = 0;
+    size_t i = 0;
+    while (i < len)
+    {
+        unsigned char ch = (unsigned char)src[i];
+        size_t start = i;
+        int type;
+        if (isspace(ch))
+        {
+            i++;
+            continue;
+        }
+        else if (isalpha(ch))
+        {
+            while (i < len && isalnum((unsigned char)src[i]))
+            {
+                i++;
+            }
+            type = reserved_word_type(&src[start], i - start);
+            if (type == -1)
+            {
+                type = T_ID;
+            }
+        }
+        else if (isdigit(ch))
+        {
+            while (i < len && isdigit((unsigned char)src[i]))
+            {
+                i++;
+            }
+            type = T_NUM;
+        }
+        else
+        {
+            char next = (i + 1 < len) ? src[i + 1] : '\0';
+            if ((ch == ':' || ch == '<' || ch == '>' || ch == '=') && next == '=')
+            {
+                type = ch == ':' ? T_ASSIGN : ch == '<' ? T_LE : ch == '>' ? T_GE : T_EQEQ;
+            }
+            else if (ch == '<' && next == '>')
+            {
+                type = T_NE;
+            }
+            else
+            {
+                const char *single = "{}(),;<>=+-*/$";
+                const int types[] = {T_LBRACE, T_RBRACE, T_LPAREN, T_RPAREN, T_COMMA, T_SEMICOLON, T_LT,
+                                     T_GT, T_EQ, T_PLUS, T_MINUS, T_STAR, T_SLASH, T_END};
+                const char *at = ch ? strchr(single, ch) : NULL;
+                type = at ? types[at - single] : T_INVALID;
+            }
+            i += (type == T_ASSIGN || type == T_LE || type == T_GE || type == T_NE || type == T_EQEQ) ? 2 : 1;
+        }
+        if (out->count == out->capacity)
+        {
+            size_t capacity = out->capacity ? out->capacity * 2 : 256;
+            Token *tokens = realloc(out->tokens, capacity * sizeof(Token));
+            if (tokens == NULL)
+            {
+                return -1;
+            }
+            out->tokens = tokens;
+            out->capacity = capacity;
+        }
+        out->tokens[out->count++] = (Token){(uint32_t)start, (uint32_t)(i - start), (uint8_t)type};
+    }
+    return 0;
+}
+
+static int same_tokens(const TokenArray *a, const TokenArray *b)
+{
+    if (a->count != b->count)
+    {
+        return 0;
+    }
+    for (size_t i = 0; i < a->count; i++)
+    {
+        const Token *x = &a->tokens[i], *y = &b->tokens[i];
+        if (x->offset != y->offset || x->length != y->length || x->type != y->type)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Vazão do lexer de referência e de cada classificação suportada pela CPU;
+// confere que todas produzem exatamente os mesmos tokens
+static int bench_lexer(const char *src, size_t len, int iterations)
+{
+    TokenArray expected = {0}, tokens = {0};
+    double t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        if (reference_tokenize(src, len, &expected) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            exit(1);
+        }
+    }
+    double ref_time = now_seconds() - t0;
+
+    printf("lexer (%d iteracoes, %zu bytes, %zu tokens)   MB/s   ganho\n", iterations, len, expected.count);
+    printf("%-12s %36.1f %6.1fx\n", "referencia", len * (double)iterations / ref_time / 1e6, 1.0);
+
+    int status = 0;
+    for (LexerImpl impl = LEXER_SCALAR; impl <= lexer_best_impl(); impl++)
+    {
+        t0 = now_seconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (tokenize_input_impl(src, len, &tokens, impl) != 0)
+            {
+                printf("Erro: Falha ao alocar memória!\n");
+                exit(1);
+            }
+        }
+        double elapsed = now_seconds() - t0;
+        int same = same_tokens(&expected, &tokens);
+        printf("%-12s %36.1f %6.1fx%s\n", lexer_impl_name(impl), len * (double)iterations / elapsed / 1e6,
+               ref_time / elapsed, same ? "" : "   DIVERGE DA REFERENCIA");
+        if (!same)
+        {
+            status = 2;
+        }
+    }
+
+    token_array_free(&expected);
+    token_array_free(&tokens);
+    return status;
+}
+
+// Gerador pseudoaleatório determinístico (xorshift64)
+static uint64_t next_random(uint64_t *state)
+{
+    uint64_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return *state = x;
+}
+
+// Lexer paralelo: vazão com várias threads e comparação diferencial com o
+// serial, sobre o arquivo e sobre textos aleatórios curtos feitos de letras,
+// dígitos, espaços e caracteres de operadores, para que as divisões entre
+// threads caiam em todas as posições possíveis (inclusive dentro de ':=')
+static int bench_parallel_lexer(const char *src, size_t len, int iterations)
+{
+    TokenArray expected = {0}, tokens = {0};
+    double t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        if (tokenize_input_impl(src, len, &expected, LEXER_AUTO) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            exit(1);
+        }
+    }
+    double serial_time = now_seconds() - t0;
+
+    long cores = sysconf(_SC_NPROCESSORS_ONLN);
+    printf("lexer paralelo (%ld nucleos)                   MB/s   ganho\n", cores);
+    printf("%-12s %36.1f %6.1fx\n", "serial", len * (double)iterations / serial_time / 1e6, 1.0);
+    int status = 0;
+    long thread_counts[] = {2, 3, 4, 8, cores};
+    for (size_t k = 0; k < sizeof(thread_counts) / sizeof(thread_counts[0]); k++)
+    {
+        t0 = now_seconds();
+        for (int i = 0; i < iterations; i++)
+        {
+            if (tokenize_input_parallel(src, len, &tokens, (int)thread_counts[k]) != 0)
+            {
+                printf("Erro: Falha ao alocar memória!\n");
+                exit(1);
+            }
+        }
+        double elapsed = now_seconds() - t0;
+        int same = same_tokens(&expected, &tokens);
+        char name[32];
+        snprintf(name, sizeof(name), "%ld threads", thread_counts[k]);
+        printf("%-12s %36.1f %6.1fx%s\n", name, len * (double)iterations / elapsed / 1e6, serial_time / elapsed,
+               same ? "" : "   DIVERGE DO SERIAL");
+        if (!same)
+        {
+            status = 2;
+        }
+    }
+
+    static const char alphabet[] = "ab19 \n\t:=<>$;&";
+    char text[512];
+    uint64_t state = 0x9e3779b97f4a7c15ull;
+    long cases = 20000, diverged = 0;
+    for (long c = 0; c < cases; c++)
+    {
+        size_t n = next_random(&state) % sizeof(text);
+        for (size_t i = 0; i < n; i++)
+        {
+            text[i] = alphabet[next_random(&state) % (sizeof(alphabet) - 1)];
+        }
+        int threads = 2 + (int)(next_random(&state) % 15);
+        if (tokenize_input_impl(text, n, &expected, LEXER_AUTO) != 0 ||
+            tokenize_input_parallel(text, n, &tokens, threads) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            exit(1);
+        }
+        if (!same_tokens(&expected, &tokens) && diverged++ == 0)
+        {
+            printf("divergencia com %d threads: '%.*s'\n", threads, (int)n, text);
+        }
+    }
+    printf("diferencial: %ld textos aleatorios, %ld divergencias\n", cases, diverged);
+    if (diverged > 0)
+    {
+        status = 2;
+    }
+
+    token_array_free(&expected);
+    token_array_free(&tokens);
+    return status;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// O primeiro erro do documento é o da análise completa (full, já feita sobre
+// text)? Confere o status, o token, o terminal esperado, o não-terminal e o
+// texto da mensagem.
+static int same_first_error(const Document *doc, const Parser *full, const char *text)
+{
+    ParseResult first;
+    ParseStatus got = document_first_error(doc, &first);
+    const ParseResult *r = parser_result(full);
+    char expected[160], message[160];
+    parse_result_message(r, text, expected, sizeof(expected));
+    document_message(doc, message, sizeof(message));
+    return got == r->status && first.offset == r->offset && first.token_index == r->token_index &&
+           first.token_type == r->token_type && first.expected == r->expected &&
+           first.nonterminal == r->nonterminal && strcmp(message, expected) == 0;
+}
+
+// Cada iteração aplica uma edição aleatória e depois a desfaz. Após cada
+// edição, o veredito, o primeiro erro e o número de tokens do documento são
+// comparados com os da análise completa do mesmo texto. Antes, documentos
+// fixos com uma função cortada dentro de um bloco aberto (o trecho termina
+// antes do 'def' seguinte) são comparados da mesma forma.
+static int bench_incremental(const char *src, size_t len, int iterations)
+{
+    static const char *const snippets[] = {"", "x", " ", ";", "}", "{", "def", " def g ( ) { } ", ":=", "1", "(", "<",
+                                           "\n", "print x ;", "$", "if ( x ) ", "else", "return"};
+    const size_t num_snippets = sizeof(snippets) / sizeof(snippets[0]);
+    static const char *const programs[] = {
+        "def f ( ) { if ( x ) ;\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { if ( x > 1 ) x := 1 ;\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { if ( x > 1 ) { x := 1 ; } else\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ;\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := a +\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { return\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( int a ,\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( )\ndef g ( ) { x := 1 ; }\n$",
+    };
+    const size_t num_programs = sizeof(programs) / sizeof(programs[0]);
+
+    size_t capacity = len + 64;
+    char *text = malloc(capacity);
+    char *check = malloc(capacity);
+    double *latencies = malloc(2 * (size_t)iterations * sizeof(double));
+    Parser *full = parser_create();
+    double t0 = now_seconds();
+    Document *doc = document_create(src, len);
+    double create_time = now_seconds() - t0;
+    if (text == NULL || check == NULL || latencies == NULL || full == NULL || doc == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    memcpy(text, src, len);
+    size_t text_len = len;
+
+    size_t verdict_diffs = 0, error_diffs = 0, token_diffs = 0, position_diffs = 0, rejected = 0;
+    for (size_t k = 0; k < num_programs; k++)
+    {
+        Document *fixed = document_create(programs[k], strlen(programs[k]));
+        if (fixed == NULL)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            exit(1);
+        }
+        parser_parse_buffer(full, programs[k], strlen(programs[k]));
+        if (!same_first_error(fixed, full, programs[k]))
+        {
+            error_diffs++;
+            printf("primeiro erro diferente no documento fixo %zu\n", k + 1);
+        }
+        document_destroy(fixed);
+    }
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    double edit_time = 0, full_time = 0;
+    size_t edits = 0, reparsed = 0, full_tokens = 0;
+    SourceMap lines = {0};
+    for (int i = 0; i < iterations; i++)
+    {
+        size_t offset = next_random(&state) % (text_len + 1);
+        size_t max_removed = text_len - offset < 8 ? text_len - offset : 8;
+        size_t removed = next_random(&state) % (max_removed + 1);
+        const char *snippet = snippets[next_random(&state) % num_snippets];
+        size_t inserted = strlen(snippet);
+        char saved[8];
+        memcpy(saved, text + offset, removed);
+
+        for (int undo = 0; undo < 2; undo++)
+        {
+            const char *ins = undo ? saved : snippet;
+            size_t ins_len = undo ? removed : inserted;
+            size_t del_len = undo ? inserted : removed;
+
+            t0 = now_seconds();
+            int status = document_edit(doc, offset, del_len, ins, ins_len);
+            latencies[edits] = now_seconds() - t0;
+            edit_time += latencies[edits];
+            if (status != 0)
+            {
+                printf("Erro: Falha ao alocar memória!\n");
+                exit(1);
+            }
+            edits++;
+            reparsed += document_reparsed_tokens(doc);
+
+            memmove(text + offset + ins_len, text + offset + del_len, text_len - offset - del_len);
+            memcpy(text + offset, ins, ins_len);
+            text_len = text_len - del_len + ins_len;
+
+            t0 = now_seconds();
+            ParseStatus expected = parser_parse_buffer(full, text, text_len);
+            full_time += now_seconds() - t0;
+            full_tokens += parser_token_count(full);
+
+            const ParseResult *r = parser_result(full);
+            verdict_diffs += (document_status(doc) == PARSE_ACCEPTED) != (expected == PARSE_ACCEPTED);
+            token_diffs += document_token_count(doc) != parser_token_count(full);
+            if (expected != PARSE_ACCEPTED)
+            {
+                rejected++;
+                error_diffs += !same_first_error(doc, full, text);
+
+                // Linha e coluna do documento contra o índice de linhas do texto inteiro
+                SourcePosition doc_pos, text_pos;
+                source_map_reset(&lines, text);
+                if (r->has_token && document_error_position(doc, &doc_pos) == 0 &&
+                    source_map_locate(&lines, r->offset, &text_pos) == 0)
+                {
+                    position_diffs += doc_pos.line != text_pos.line || doc_pos.column != text_pos.column ||
+                                      doc_pos.line_start != text_pos.line_start;
+                }
+            }
+        }
+    }
+    document_copy_text(doc, check);
+    int same_text = document_length(doc) == text_len && memcmp(check, text, text_len) == 0;
+
+    printf("documento: %zu bytes, %zu funcoes, criado em %.3f ms\n", len, document_function_count(doc),
+           create_time * 1e3);
+    qsort(latencies, edits, sizeof(double), compare_doubles);
+    printf("incremental: %zu edicoes, %.2f us/edicao (mediana %.2f us, maximo %.2f us), %.1f tokens reanalisados "
+           "por edicao\n",
+           edits, edit_time / edits * 1e6, latencies[edits / 2] * 1e6, latencies[edits - 1] * 1e6,
+           (double)reparsed / edits);
+    printf("analise completa: %.2f us/edicao, %.1f tokens por edicao (%.1fx a incremental)\n",
+           full_time / edits * 1e6, (double)full_tokens / edits, full_time / edit_time);
+    printf("diferencas: veredito %zu, tokens %zu, texto %s; primeiro erro diferente em %zu de %zu rejeicoes "
+           "e %zu documentos fixos (linha e coluna em %zu)\n",
+           verdict_diffs, token_diffs, same_text ? "igual" : "DIFERENTE", error_diffs, rejected, num_programs,
+           position_diffs);
+    source_map_free(&lines);
+
+    document_destroy(doc);
+    parser_destroy(full);
+    free(text);
+    free(check);
+    free(latencies);
+    return (verdict_diffs || error_diffs || token_diffs || position_diffs || !same_text) ? 2 : 0;
+}
+
+// Copia tokens em mutant (com capacidade para tokens->count + 4) com até 4
+// mudanças aleatórias: troca do tipo de um token, remoção ou duplicação
+static void mutate_tokens(TokenArray *mutant, const TokenArray *tokens, uint64_t *state)
+{
+    memcpy(mutant->tokens, tokens->tokens, tokens->count * sizeof(Token));
+    mutant->count = tokens->count;
+    int changes = 1 + (int)(next_random(state) % 4);
+    for (int c = 0; c < changes && mutant->count > 0; c++)
+    {
+        size_t at = next_random(state) % mutant->count;
+        int kind = (int)(next_random(state) % 3);
+        if (kind == 0)
+        {
+            uint64_t type = next_random(state) % (MAX_TERMINALS + 1);
+            mutant->tokens[at].type = type == MAX_TERMINALS ? T_INVALID : (int)type;
+        }
+        else if (kind == 1)
+        {
+            memmove(&mutant->tokens[at], &mutant->tokens[at + 1], (mutant->count - at - 1) * sizeof(Token));
+            mutant->count--;
+        }
+        else
+        {
+            memmove(&mutant->tokens[at + 1], &mutant->tokens[at], (mutant->count - at) * sizeof(Token));
+            mutant->count++;
+        }
+    }
+}
+
+// Os dois motores concordam sobre tokens[begin, end) a partir de start?
+// Confere o veredito e, nos erros, o token, o terminal esperado e o
+// não-terminal sem produção.
+static int same_result(Parser *parser, DirectStack *stack, const TokenArray *tokens, size_t begin, size_t end,
+                       int start)
+{
+    Token end_marker = end < tokens->count ? tokens->tokens[end] : (Token){0, 0, T_END};
+    ParseStatus expected = start == N_S ? parser_parse_tokens(parser, NULL, tokens)
+                                        : parser_parse_range(parser, NULL, tokens, begin, end, start, NULL);
+    const ParseResult *r = parser_result(parser);
+    DirectError error;
+    ParseStatus got = direct_parse(tokens->tokens, begin, end, start, start == N_S ? NULL : &end_marker, stack, &error);
+    if (got != expected)
+    {
+        return 0;
+    }
+    return got != PARSE_SYNTAX_ERROR || (error.index == r->token_index && error.expected == r->expected &&
+                                         error.nonterminal == r->nonterminal);
+}
+
+// Roda os dois motores sobre o arquivo, sobre cada função como FLIST e sobre
+// variações aleatórias dos tokens (troca, remoção e duplicação); depois mede
+// a vazão de cada um sobre o arquivo
+static int bench_direct(const char *src, size_t len, int iterations)
+{
+    TokenArray tokens = {0}, mutant = {0};
+    Parser *parser = parser_create();
+    DirectStack stack = {NULL, 0};
+    if (tokenize_input(src, len, &tokens) != 0 || parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+
+    size_t cases = 0, diffs = 0, rejected = 0;
+    cases++;
+    diffs += !same_result(parser, &stack, &tokens, 0, tokens.count, N_S);
+    for (size_t begin = 0; begin < tokens.count && tokens.tokens[begin].type != T_END; begin++)
+    {
+        if (tokens.tokens[begin].type != T_DEF)
+        {
+            continue;
+        }
+        size_t end = begin + 1;
+        while (end < tokens.count && tokens.tokens[end].type != T_DEF && tokens.tokens[end].type != T_END)
+        {
+            end++;
+        }
+        cases++;
+        diffs += !same_result(parser, &stack, &tokens, begin, end, N_FLIST);
+    }
+
+    // Variações: cada uma é uma cópia dos tokens com até 4 mudanças
+    mutant.tokens = malloc((tokens.count + 8) * sizeof(Token));
+    if (mutant.tokens == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    mutant.capacity = tokens.count + 8;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    int variants = iterations < 200 ? iterations : 200;
+    for (int v = 0; v < variants; v++)
+    {
+        mutate_tokens(&mutant, &tokens, &state);
+        cases++;
+        int same = same_result(parser, &stack, &mutant, 0, mutant.count, N_S);
+        diffs += !same;
+        rejected += parser_result(parser)->status != PARSE_ACCEPTED;
+    }
+
+    // Vazão (o parser foi compilado sem PARSER_DIRECT: é o laço interpretado)
+    double t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        parser_parse_tokens(parser, src, &tokens);
+    }
+    double table_time = now_seconds() - t0;
+    DirectError error;
+    t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        direct_parse(tokens.tokens, 0, tokens.count, N_S, NULL, &stack, &error);
+    }
+    double direct_time = now_seconds() - t0;
+
+    double total = tokens.count * (double)iterations;
+    printf("arquivo: %zu bytes, %zu tokens\n", len, tokens.count);
+    printf("tabela: %.3f us/iteracao, %.2f Mtokens/s\n", table_time / iterations * 1e6, total / table_time / 1e6);
+    printf("direto: %.3f us/iteracao, %.2f Mtokens/s (%.2fx a tabela)\n", direct_time / iterations * 1e6,
+           total / direct_time / 1e6, table_time / direct_time);
+    printf("diferencas: %zu em %zu casos (%d variacoes, %zu rejeitadas)\n", diffs, cases, variants, rejected);
+
+    parser_destroy(parser);
+    token_array_free(&tokens);
+    free(mutant.tokens);
+    free(stack.data);
+    return diffs ? 2 : 0;
+}
+
+// O modo dividido concorda com a análise sequencial sobre tokens? Confere o
+// veredito e, na primeira função rejeitada, o token e a mensagem do erro.
+// Programas que não são uma lista de funções não contam como caso.
+static int same_split(Parser *parser, const char *src, const TokenArray *tokens, long workers, size_t *cases)
+{
+    size_t *starts = NULL;
+    long n = split_functions(tokens, &starts);
+    if (n == 0)
+    {
+        return 1;
+    }
+    ParseResult *results = n > 0 ? malloc((size_t)n * sizeof(ParseResult)) : NULL;
+    if (results == NULL || split_parse(src, tokens, starts, (size_t)n, workers, results) < 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    (*cases)++;
+    parser_parse_tokens(parser, src, tokens);
+    const ParseResult *r = parser_result(parser);
+    const ParseResult *first = NULL;
+    for (long i = 0; i < n && first == NULL; i++)
+    {
+        first = results[i].status != PARSE_ACCEPTED ? &results[i] : NULL;
+    }
+    int same = r->status == PARSE_ACCEPTED;
+    if (first != NULL)
+    {
+        char expected[160], got[160];
+        parse_result_message(r, src, expected, sizeof(expected));
+        parse_result_message(first, src, got, sizeof(got));
+        same = first->status == r->status && first->token_index == r->token_index && strcmp(expected, got) == 0;
+    }
+    free(results);
+    free(starts);
+    return same;
+}
+
+// Compara o modo dividido com a análise sequencial sobre programas fixos
+// (erros na fronteira entre funções, texto depois do primeiro '$'), sobre o
+// arquivo e sobre variações aleatórias dos tokens dele
+static int bench_split(const char *src, size_t len, int iterations)
+{
+    static const char *const programs[] = {
+        "def f ( ) { x := 1 ; }\n$\ndef g ( ) { & }\n$\n",
+        "def f ( )\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ; } )\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ; } }\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ; } {\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ; $ }\ndef g ( ) { & }\n$",
+        "def f ( ) { if ( x > 1 ) x := 1 ;\ndef g ( ) { x := 1 ; }\n$",
+        "def f ( ) { x := 1 ; }\ndef g ( ) { x := 1 ; }\n$",
+    };
+    const size_t num_programs = sizeof(programs) / sizeof(programs[0]);
+    const long workers = 4;
+
+    Parser *parser = parser_create();
+    TokenArray tokens = {0}, mutant = {0};
+    if (parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    size_t cases = 0, diffs = 0;
+    for (size_t k = 0; k < num_programs; k++)
+    {
+        if (tokenize_input(programs[k], strlen(programs[k]), &tokens) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            exit(1);
+        }
+        if (!same_split(parser, programs[k], &tokens, workers, &cases))
+        {
+            diffs++;
+            printf("diferenca no programa %zu\n", k + 1);
+        }
+    }
+
+    if (tokenize_input(src, len, &tokens) != 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    diffs += !same_split(parser, src, &tokens, workers, &cases);
+    mutant.tokens = malloc((tokens.count + 8) * sizeof(Token));
+    if (mutant.tokens == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    mutant.capacity = tokens.count + 8;
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    int variants = iterations < 200 ? iterations : 200;
+    for (int v = 0; v < variants; v++)
+    {
+        mutate_tokens(&mutant, &tokens, &state);
+        diffs += !same_split(parser, src, &mutant, workers, &cases);
+    }
+    printf("diferencas: %zu em %zu casos (%zu programas fixos, %d variacoes, %ld threads)\n", diffs, cases,
+           num_programs, variants, workers);
+
+    parser_destroy(parser);
+    token_array_free(&tokens);
+    free(mutant.tokens);
+    return diffs ? 2 : 0;
+}
+
+typedef struct
+{
+    size_t steps;  // iterações do laço do parser
+    size_t pushes;
+    size_t pops;
+} StackOps;
+
+// Refaz a análise só sobre as tabelas, contando as operações na pilha, com e
+// sem as expansões encadeadas (o parser não conta nada no laço principal)
+static StackOps count_stack_ops(const TokenArray *tokens, int use_chains)
+{
+    StackOps ops = {0, 0, 0};
+    size_t capacity = 256, top = 0, i = 0;
+    symbol_t *stack = malloc(capacity);
+    if (stack == NULL)
+    {
+        return ops;
+    }
+    stack[top++] = T_END;
+    stack[top++] = SYM_NONTERMINAL(N_S);
+    ops.pushes = 2;
+    while (top > 0 && i < tokens->count)
+    {
+        ops.steps++;
+        symbol_t s = stack[top - 1];
+        int type = tokens->tokens[i].type;
+        if (!IS_NONTERMINAL(s))
+        {
+            if (s != type)
+            {
+                break;
+            }
+            top--;
+            ops.pops++;
+            i++;
+            continue;
+        }
+        int row = s - MAX_TERMINALS;
+        if (type == T_INVALID || prod_table[row][type] == NO_PRODUCTION)
+        {
+            break;
+        }
+        const symbol_t *symbols;
+        size_t length;
+        if (use_chains)
+        {
+            const Chain *chain = &chains[chain_table[row][type]];
+            symbols = &chain_symbols[chain->symbols];
+            length = chain->length;
+            i += chain->matches;
+        }
+        else
+        {
+            const Production *production = &productions[prod_table[row][type]];
+            symbols = &prod_symbols[production->offset];
+            length = production->length;
+        }
+        top--;
+        ops.pops++;
+        if (top + length > capacity)
+        {
+            capacity = (top + length) * 2;
+            symbol_t *bigger = realloc(stack, capacity);
+            if (bigger == NULL)
+            {
+                break;
+            }
+            stack = bigger;
+        }
+        memcpy(stack + top, symbols, length);
+        top += length;
+        ops.pushes += length;
+    }
+    free(stack);
+    return ops;
+}
+
+static void bench_parse(const char *path, const char *src, size_t len, int iterations)
+{
+    TokenArray tokens = {0};
+    size_t allocs_before = alloc_count;
+    double t0 = now_seconds();
+    if (tokenize_input(src, len, &tokens) != 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    double lex_time = now_seconds() - t0;
+    size_t lex_allocs = alloc_count - allocs_before;
+
+    // Primeira execução: o contexto e a arena ainda estão vazios
+    allocs_before = alloc_count;
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        exit(1);
+    }
+    int accepted = parser_parse_tokens(parser, src, &tokens) == PARSE_ACCEPTED;
+    size_t cold_allocs = alloc_count - allocs_before;
+
+    allocs_before = alloc_count;
+    t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        parser_parse_tokens(parser, src, &tokens);
+    }
+    double parse_time = now_seconds() - t0;
+    size_t warm_allocs = alloc_count - allocs_before;
+
+    // Mesma análise construindo a árvore sintática
+    parser_set_build_tree(parser, 1);
+    parser_parse_tokens(parser, src, &tokens);
+    uint32_t tree_nodes = parser_tree(parser)->count;
+    t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        parser_parse_tokens(parser, src, &tokens);
+    }
+    double tree_time = now_seconds() - t0;
+    parser_set_build_tree(parser, 0);
+
+    // Sem as expansões encadeadas: uma produção por passo
+    parser_set_chains(parser, 0);
+    t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        parser_parse_tokens(parser, src, &tokens);
+    }
+    double plain_time = now_seconds() - t0;
+    parser_set_chains(parser, 1);
+    StackOps plain = count_stack_ops(&tokens, 0);
+    StackOps chained = count_stack_ops(&tokens, 1);
+    double n = tokens.count ? (double)tokens.count : 1.0;
+
+    printf("arquivo: %s (%zu bytes, %zu tokens)\n", path, len, tokens.count);
+    printf("veredito: %s\n", accepted ? "aceita" : "rejeitada");
+    printf("lexer: %.3f ms, %zu alocacoes\n", lex_time * 1e3, lex_allocs);
+    printf("parse: %d iteracoes, %.3f us/iteracao, %.2f Mtokens/s\n", iterations,
+           parse_time / iterations * 1e6, tokens.count * (double)iterations / parse_time / 1e6);
+    printf("alocacoes no parse: %zu na primeira execucao (com o contexto), %zu nas %d seguintes\n",
+           cold_allocs, warm_allocs, iterations);
+    printf("parse com arvore: %.3f us/iteracao, %u nos (%zu bytes), %.2fx o parse sem arvore\n",
+           tree_time / iterations * 1e6, tree_nodes, tree_nodes * sizeof(TreeNode), tree_time / parse_time);
+    printf("parse sem cadeias: %.3f us/iteracao (%.2fx o parse com cadeias)\n", plain_time / iterations * 1e6,
+           plain_time / parse_time);
+    printf("pilha por token: sem cadeias %.2f passos, %.2f push + %.2f pop; com cadeias %.2f passos, "
+           "%.2f push + %.2f pop\n",
+           plain.steps / n, plain.pushes / n, plain.pops / n, chained.steps / n, chained.pushes / n,
+           chained.pops / n);
+
+    parser_destroy(parser);
+    token_array_free(&tokens);
+}
+
+// Pico de memória residente do processo, em KiB
+static long peak_rss_kib(void)
+{
+    struct rusage usage;
+    return getrusage(RUSAGE_SELF, &usage) == 0 ? usage.ru_maxrss : -1;
+}
+
+// Uma execução completa, fase por fase, como a do p3 -q: a leitura inclui
+// tocar todas as páginas do arquivo mapeado, para que o custo de E/S não
+// apareça no lexer. O parse é medido na primeira execução (arena vazia) e na
+// média das seguintes. A saída é um único objeto JSON numa linha.
+static int bench_phases(const char *path, int iterations)
+{
+    size_t allocs_before = alloc_count;
+    double t0 = now_seconds();
+    SourceFile source;
+    if (source_open(&source, path) != 0)
+    {
+        perror("Erro ao abrir o arquivo");
+        return 1;
+    }
+    unsigned checksum = 0;
+    for (size_t i = 0; i < source.len; i += 4096)
+    {
+        checksum += (unsigned char)source.data[i];
+    }
+    double read_time = now_seconds() - t0;
+    size_t read_allocs = alloc_count - allocs_before;
+
+    TokenArray tokens = {0};
+    allocs_before = alloc_count;
+    t0 = now_seconds();
+    if (tokenize_input(source.data, source.len, &tokens) != 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    double lex_time = now_seconds() - t0;
+    size_t lex_allocs = alloc_count - allocs_before;
+
+    allocs_before = alloc_count;
+    t0 = now_seconds();
+    Parser *parser = parser_create();
+    double init_time = now_seconds() - t0;
+    size_t init_allocs = alloc_count - allocs_before;
+    if (parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+
+    allocs_before = alloc_count;
+    t0 = now_seconds();
+    ParseStatus status = parser_parse_tokens(parser, source.data, &tokens);
+    double cold_time = now_seconds() - t0;
+    size_t cold_allocs = alloc_count - allocs_before;
+
+    allocs_before = alloc_count;
+    t0 = now_seconds();
+    for (int i = 0; i < iterations; i++)
+    {
+        parser_parse_tokens(parser, source.data, &tokens);
+    }
+    double warm_time = (now_seconds() - t0) / iterations;
+    size_t warm_allocs = alloc_count - allocs_before;
+
+    const ParseResult *r = parser_result(parser);
+    double total = read_time + lex_time + init_time + cold_time;
+    printf("{\"file\": \"");
+    for (const char *c = path; *c; c++)
+    {
+        if (*c == '"' || *c == '\\')
+        {
+            putchar('\\');
+        }
+        putchar(*c);
+    }
+    printf("\", \"bytes\": %zu, \"tokens\": %zu, \"status\": %d, \"error_token\": %zd, "
+           "\"read_s\": %.9f, \"lexer_s\": %.9f, \"init_s\": %.9f, \"parse_cold_s\": %.9f, "
+           "\"parse_s\": %.9f, \"iterations\": %d, \"total_s\": %.9f, "
+           "\"lexer_mb_s\": %.3f, \"parse_tokens_s\": %.0f, \"total_tokens_s\": %.0f, "
+           "\"allocs_read\": %zu, \"allocs_lexer\": %zu, \"allocs_init\": %zu, \"allocs_parse_cold\": %zu, "
+           "\"allocs_parse\": %zu, \"peak_rss_kib\": %ld, \"checksum\": %u}\n",
+           source.len, tokens.count, (int)status,
+           status == PARSE_SYNTAX_ERROR ? (ssize_t)r->token_index : (ssize_t)-1, read_time, lex_time, init_time,
+           cold_time, warm_time, iterations, total, lex_time > 0 ? source.len / lex_time / 1e6 : 0.0,
+           warm_time > 0 ? tokens.count / warm_time : 0.0, total > 0 ? tokens.count / total : 0.0, read_allocs,
+           lex_allocs, init_allocs, cold_allocs, warm_allocs / iterations, peak_rss_kib(), checksum);
+
+    parser_destroy(parser);
+    token_array_free(&tokens);
+    source_close(&source);
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int lookup = argc > 1 && strcmp(argv[1], "--lookup") == 0;
+    int lexer = argc > 1 && strcmp(argv[1], "--lexer") == 0;
+    int incremental = argc > 1 && strcmp(argv[1], "--incremental") == 0;
+    int direct = argc > 1 && strcmp(argv[1], "--direct") == 0;
+    int phases = argc > 1 && strcmp(argv[1], "--phases") == 0;
+    int split = argc > 1 && strcmp(argv[1], "--split") == 0;
+    if (lookup || lexer || incremental || direct || phases || split)
+    {
+        argc--;
+        argv++;
+    }
+    if (argc < 2 || argc > 3)
+    {
+        printf("Uso: %s [--lookup | --lexer | --incremental | --direct | --phases | --split] <caminho_para_arquivo> [iteracoes]\n", argv[0]);
+        return 1;
+    }
+    int iterations = (argc == 3) ? atoi(argv[2]) : 1000;
+    if (iterations <= 0)
+    {
+        iterations = 1;
+    }
+
+    if (phases)
+    {
+        return bench_phases(argv[1], iterations);
+    }
+
+    SourceFile source;
+    if (source_open(&source, argv[1]) != 0)
+    {
+        perror("Erro ao abrir o arquivo");
+        return 1;
+    }
+    const char *src = source.data;
+    size_t len = source.len;
+
+    int status = 0;
+    if (lexer)
+    {
+        status = bench_lexer(src, len, iterations);
+        int parallel = bench_parallel_lexer(src, len, iterations);
+        status = status ? status : parallel;
+    }
+    else if (incremental)
+    {
+        status = bench_incremental(src, len, iterations);
+    }
+    else if (direct)
+    {
+        status = bench_direct(src, len, iterations);
+    }
+    else if (split)
+    {
+        status = bench_split(src, len, iterations);
+    }
+    else if (lookup)
+    {
+        TokenArray tokens = {0};
+        if (tokenize_input(src, len, &tokens) != 0)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            return 1;
+        }
+        bench_lookup(src, &tokens, iterations);
+        token_array_free(&tokens);
+    }
+    else
+    {
+        bench_parse(argv[1], src, len, iterations);
+    }
+
+    source_close(&source);
+    return status;
+}
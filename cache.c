@@ -0,0 +1,312 @@
+#include "cache.h"
+#include "parser.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Formato do arquivo (na ordem de bytes da máquina): cabeçalho seguido das
+// entradas, cada uma com um registro fixo e o diagnóstico sem o '\0'
+#define CACHE_MAGIC "P3RC"
+#define CACHE_FORMAT 1
+
+typedef struct
+{
+    char magic[4];
+    uint32_t format;
+    uint32_t grammar_version;
+    uint32_t count;
+} CacheHeader;
+
+typedef struct
+{
+    uint64_t hash;
+    uint64_t length;
+    uint64_t tokens;
+    int32_t status;
+    uint32_t message_length;
+} CacheRecord;
+
+// XXH64 (https://github.com/Cyan4973/xxHash), implementação direta
+#define PRIME64_1 11400714785074694791ULL
+#define PRIME64_2 14029467366897019727ULL
+#define PRIME64_3 1609587929392839161ULL
+#define PRIME64_4 9650029242287828579ULL
+#define PRIME64_5 2870177450012600261ULL
+
+static inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t read64(const unsigned char *p)
+{
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint32_t read32(const unsigned char *p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t xxh_round(uint64_t acc, uint64_t input)
+{
+    acc += input * PRIME64_2;
+    return rotl64(acc, 31) * PRIME64_1;
+}
+
+static inline uint64_t xxh_merge(uint64_t acc, uint64_t v)
+{
+    acc ^= xxh_round(0, v);
+    return acc * PRIME64_1 + PRIME64_4;
+}
+
+static uint64_t xxh64(const void *data, size_t len, uint64_t seed)
+{
+    const unsigned char *p = data;
+    const unsigned char *end = p + len;
+    uint64_t h;
+
+    if (len >= 32)
+    {
+        uint64_t v1 = seed + PRIME64_1 + PRIME64_2;
+        uint64_t v2 = seed + PRIME64_2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - PRIME64_1;
+        const unsigned char *limit = end - 32;
+        do
+        {
+            v1 = xxh_round(v1, read64(p));
+            v2 = xxh_round(v2, read64(p + 8));
+            v3 = xxh_round(v3, read64(p + 16));
+            v4 = xxh_round(v4, read64(p + 24));
+            p += 32;
+        } while (p <= limit);
+        h = rotl64(v1, 1) + rotl64(v2, 7) + rotl64(v3, 12) + rotl64(v4, 18);
+        h = xxh_merge(h, v1);
+        h = xxh_merge(h, v2);
+        h = xxh_merge(h, v3);
+        h = xxh_merge(h, v4);
+    }
+    else
+    {
+        h = seed + PRIME64_5;
+    }
+
+    h += (uint64_t)len;
+    for (; p + 8 <= end; p += 8)
+    {
+        h ^= xxh_round(0, read64(p));
+        h = rotl64(h, 27) * PRIME64_1 + PRIME64_4;
+    }
+    if (p + 4 <= end)
+    {
+        h ^= (uint64_t)read32(p) * PRIME64_1;
+        h = rotl64(h, 23) * PRIME64_2 + PRIME64_3;
+        p += 4;
+    }
+    for (; p < end; p++)
+    {
+        h ^= *p * PRIME64_5;
+        h = rotl64(h, 11) * PRIME64_1;
+    }
+
+    h ^= h >> 33;
+    h *= PRIME64_2;
+    h ^= h >> 29;
+    h *= PRIME64_3;
+    h ^= h >> 32;
+    return h;
+}
+
+// A versão da gramática entra como semente: uma tabela nova muda todas as chaves
+uint64_t cache_hash(const void *data, size_t len)
+{
+    return xxh64(data, len, grammar_version);
+}
+
+static int compare_entries(const void *a, const void *b)
+{
+    const CacheEntry *x = a, *y = b;
+    if (x->hash != y->hash)
+    {
+        return x->hash < y->hash ? -1 : 1;
+    }
+    if (x->length != y->length)
+    {
+        return x->length < y->length ? -1 : 1;
+    }
+    return 0;
+}
+
+int cache_add(ResultCache *cache, uint64_t hash, uint64_t length, uint64_t tokens, int status, const char *message)
+{
+    if (cache->count == cache->capacity)
+    {
+        size_t capacity = cache->capacity ? cache->capacity * 2 : 256;
+        CacheEntry *entries = realloc(cache->entries, capacity * sizeof(CacheEntry));
+        if (entries == NULL)
+        {
+            return -1;
+        }
+        cache->entries = entries;
+        cache->capacity = capacity;
+    }
+    char *copy = strdup(message);
+    if (copy == NULL)
+    {
+        return -1;
+    }
+    cache->entries[cache->count++] = (CacheEntry){hash, length, tokens, status, copy};
+    return 0;
+}
+
+// Ordena e remove as entradas repetidas (o mesmo conteúdo visto em mais de
+// um arquivo): o resultado só depende da chave, então qualquer uma serve
+static void sort_entries(ResultCache *cache)
+{
+    if (cache->count < 2)
+    {
+        return;
+    }
+    qsort(cache->entries, cache->count, sizeof(CacheEntry), compare_entries);
+    size_t n = 1;
+    for (size_t i = 1; i < cache->count; i++)
+    {
+        if (compare_entries(&cache->entries[i], &cache->entries[n - 1]) == 0)
+        {
+            free(cache->entries[i].message);
+            continue;
+        }
+        cache->entries[n++] = cache->entries[i];
+    }
+    cache->count = n;
+}
+
+int cache_load(ResultCache *cache, const char *path)
+{
+    memset(cache, 0, sizeof(*cache));
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return 0; // primeira execução
+    }
+
+    int status = 0;
+    CacheHeader header;
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, CACHE_MAGIC, 4) != 0 ||
+        header.format != CACHE_FORMAT || header.grammar_version != grammar_version)
+    {
+        status = 1;
+    }
+    char *message = NULL;
+    size_t message_capacity = 0;
+    for (uint32_t i = 0; status == 0 && i < header.count; i++)
+    {
+        CacheRecord record;
+        if (fread(&record, sizeof(record), 1, fp) != 1 || record.message_length > (1u << 20))
+        {
+            status = 1;
+            break;
+        }
+        if (record.message_length + 1 > message_capacity)
+        {
+            message_capacity = record.message_length + 1;
+            char *bigger = realloc(message, message_capacity);
+            if (bigger == NULL)
+            {
+                status = -1;
+                break;
+            }
+            message = bigger;
+        }
+        if (fread(message, 1, record.message_length, fp) != record.message_length)
+        {
+            status = 1;
+            break;
+        }
+        message[record.message_length] = '\0';
+        if (cache_add(cache, record.hash, record.length, record.tokens, record.status, message) != 0)
+        {
+            status = -1;
+        }
+    }
+    free(message);
+    fclose(fp);
+
+    if (status != 0)
+    {
+        cache_free(cache); // um arquivo inválido é tratado como cache vazio
+        return status;
+    }
+    sort_entries(cache);
+    return 0;
+}
+
+const CacheEntry *cache_find(const ResultCache *cache, uint64_t hash, uint64_t length)
+{
+    if (cache->count == 0)
+    {
+        return NULL;
+    }
+    CacheEntry key = {hash, length, 0, 0, NULL};
+    return bsearch(&key, cache->entries, cache->count, sizeof(CacheEntry), compare_entries);
+}
+
+// Grava num arquivo temporário e renomeia: uma execução interrompida nunca
+// deixa um cache truncado
+int cache_save(ResultCache *cache, const char *path)
+{
+    sort_entries(cache);
+    if (cache->count > UINT32_MAX)
+    {
+        return -1;
+    }
+
+    size_t n = strlen(path) + 5;
+    char *tmp = malloc(n);
+    if (tmp == NULL)
+    {
+        return -1;
+    }
+    snprintf(tmp, n, "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    if (fp == NULL)
+    {
+        free(tmp);
+        return -1;
+    }
+
+    CacheHeader header = {{0}, CACHE_FORMAT, grammar_version, (uint32_t)cache->count};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    int ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+    for (size_t i = 0; ok && i < cache->count; i++)
+    {
+        const CacheEntry *e = &cache->entries[i];
+        CacheRecord record = {e->hash, e->length, e->tokens, e->status, (uint32_t)strlen(e->message)};
+        ok = fwrite(&record, sizeof(record), 1, fp) == 1 &&
+             fwrite(e->message, 1, record.message_length, fp) == record.message_length;
+    }
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp, path) != 0)
+    {
+        remove(tmp);
+        free(tmp);
+        return -1;
+    }
+    free(tmp);
+    return 0;
+}
+
+void cache_free(ResultCache *cache)
+{
+    for (size_t i = 0; i < cache->count; i++)
+    {
+        free(cache->entries[i].message);
+    }
+    free(cache->entries);
+    memset(cache, 0, sizeof(*cache));
+}
@@ -0,0 +1,39 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Cache em disco de resultados de validação, indexado pelo hash do conteúdo
+// do arquivo (XXH64 com a versão da gramática como semente) e pelo tamanho.
+// Guarda o veredito e o diagnóstico, de modo que um arquivo inalterado é
+// resolvido com uma única passada de hash, sem lexer nem parser.
+typedef struct
+{
+    uint64_t hash;
+    uint64_t length;
+    uint64_t tokens;
+    int status;    // ParseStatus
+    char *message; // diagnóstico (vazio se aceito)
+} CacheEntry;
+
+typedef struct
+{
+    CacheEntry *entries; // ordenadas por (hash, length) para a busca binária
+    size_t count;
+    size_t capacity;
+} ResultCache;
+
+uint64_t cache_hash(const void *data, size_t len);
+
+// Retorna 0 se carregou (ou o arquivo não existe), 1 se o arquivo foi
+// descartado (outra versão da gramática ou corrompido) e -1 sem memória
+int cache_load(ResultCache *cache, const char *path);
+const CacheEntry *cache_find(const ResultCache *cache, uint64_t hash, uint64_t length);
+
+// Acrescenta uma entrada; a ordem da busca só vale de novo após cache_save
+int cache_add(ResultCache *cache, uint64_t hash, uint64_t length, uint64_t tokens, int status, const char *message);
+int cache_save(ResultCache *cache, const char *path);
+void cache_free(ResultCache *cache);
+
+#endif
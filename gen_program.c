@@ -0,0 +1,337 @@
+// Gerador de programas sintéticos para o benchmark: escreve na saída padrão
+// um programa da linguagem com o tamanho e o formato pedidos, válido ou com
+// erros sintáticos injetados. A saída é determinística para cada semente.
+//
+// Uso: ./gen_program [-f defs|deep|expr] [-s tamanho] [-d profundidade] [-e erros] [-r semente] > programa.txt
+//
+//   -f defs   muitas funções pequenas, com declarações, atribuições, if/else,
+//             chamadas e print (padrão)
+//   -f deep   funções com if e blocos { } aninhados -d níveis
+//   -f expr   funções com expressões longas: -d termos por expressão, com
+//             parênteses aninhados
+//   -s        tamanho aproximado em bytes; aceita K, M e G (padrão 1M)
+//   -d        profundidade do aninhamento ou termos por expressão (padrão 100)
+//   -e        erros por mil funções (padrão 0: programa válido); com -e maior
+//             que 0, há sempre pelo menos um erro
+//   -r        semente do gerador pseudoaleatório
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum
+{
+    SHAPE_DEFS,
+    SHAPE_DEEP,
+    SHAPE_EXPR
+} Shape;
+
+typedef struct
+{
+    FILE *out;
+    uint64_t random;
+    size_t bytes;
+    size_t functions;
+    size_t errors;
+} Generator;
+
+static uint64_t next_random(Generator *g)
+{
+    uint64_t x = g->random;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return g->random = x;
+}
+
+static unsigned pick(Generator *g, unsigned n)
+{
+    return (unsigned)(next_random(g) % n);
+}
+
+static void emit(Generator *g, const char *text)
+{
+    size_t n = strlen(text);
+    fwrite(text, 1, n, g->out);
+    g->bytes += n;
+}
+
+static void emitf(Generator *g, const char *format, ...) __attribute__((format(printf, 2, 3)));
+
+static void emitf(Generator *g, const char *format, ...)
+{
+    char buf[256];
+    va_list args;
+    va_start(args, format);
+    int n = vsnprintf(buf, sizeof(buf), format, args);
+    va_end(args);
+    if (n > 0)
+    {
+        emit(g, buf);
+    }
+}
+
+// Variáveis visíveis em todas as funções: os parâmetros a, b e os locais c, d
+static const char *const variables[] = {"a", "b", "c", "d"};
+
+static const char *variable(Generator *g)
+{
+    return variables[pick(g, 4)];
+}
+
+// Fator: número, variável, chamada a uma função já definida ou subexpressão
+static void emit_factor(Generator *g, int depth)
+{
+    unsigned kind = pick(g, depth > 0 ? 5 : 3);
+    if (kind == 0)
+    {
+        emitf(g, "%u", pick(g, 1000));
+    }
+    else if (kind == 1 || (kind == 2 && g->functions == 0))
+    {
+        emit(g, variable(g));
+    }
+    else if (kind == 2)
+    {
+        emitf(g, "f%zu ( %s , %s )", (size_t)(next_random(g) % g->functions), variable(g), variable(g));
+    }
+    else
+    {
+        emit(g, "( ");
+        emit_factor(g, depth - 1);
+        emit(g, pick(g, 2) ? " + " : " * ");
+        emit_factor(g, depth - 1);
+        emit(g, " )");
+    }
+}
+
+// Expressão aritmética com terms fatores
+static void emit_numexpr(Generator *g, unsigned terms, int depth)
+{
+    static const char *const operators[] = {" + ", " - ", " * ", " / "};
+    emit_factor(g, depth);
+    for (unsigned i = 1; i < terms; i++)
+    {
+        emit(g, operators[pick(g, 4)]);
+        emit_factor(g, depth);
+    }
+}
+
+static void emit_condition(Generator *g)
+{
+    static const char *const relations[] = {" < ", " <= ", " > ", " >= ", " == ", " <> "};
+    emit_numexpr(g, 1 + pick(g, 2), 1);
+    emit(g, relations[pick(g, 6)]);
+    emit_numexpr(g, 1 + pick(g, 2), 1);
+}
+
+// Comando simples (sem aninhamento), com indentação
+static void emit_simple(Generator *g, int indent)
+{
+    emitf(g, "%*s", indent, "");
+    switch (pick(g, 4))
+    {
+    case 0:
+        emit(g, "print ");
+        emit_numexpr(g, 1 + pick(g, 3), 1);
+        emit(g, " ;\n");
+        break;
+    case 1:
+        emit(g, "if ( ");
+        emit_condition(g);
+        emitf(g, " ) { %s := %s ; } else { print %s ; }\n", variable(g), variable(g), variable(g));
+        break;
+    default:
+        emitf(g, "%s := ", variables[2 + pick(g, 2)]);
+        emit_numexpr(g, 1 + pick(g, 4), 2);
+        emit(g, " ;\n");
+        break;
+    }
+}
+
+// Comando com um erro sintático: cada um quebra uma regra diferente
+static void emit_error(Generator *g, int indent)
+{
+    static const char *const broken[] = {
+        "c = a + b ;\n",              // '=' no lugar de ':='
+        "c := a + ;\n",               // operando faltando
+        "print a b ;\n",              // operador faltando
+        "int c d ;\n",                // ',' faltando
+        "if c > d ) { print c ; }\n", // '(' faltando
+        "return a + b ;\n",           // return só aceita um id
+        "c := ( a + b ;\n",           // ')' faltando
+        "d := f ( 1 ) ;\n",           // argumento que não é id
+    };
+    emitf(g, "%*s%s", indent, "", broken[pick(g, sizeof(broken) / sizeof(broken[0]))]);
+    g->errors++;
+}
+
+static void emit_body(Generator *g, Shape shape, unsigned depth)
+{
+    emit(g, "  int c , d ;\n");
+    if (shape == SHAPE_DEFS)
+    {
+        unsigned statements = 2 + pick(g, 6);
+        for (unsigned i = 0; i < statements; i++)
+        {
+            emit_simple(g, 2);
+        }
+    }
+    else if (shape == SHAPE_DEEP)
+    {
+        // Alterna if e blocos; os níveis internos ficam sem indentação para
+        // que o tamanho cresça linearmente com a profundidade
+        for (unsigned i = 0; i < depth; i++)
+        {
+            if (i % 2 == 0)
+            {
+                emitf(g, "if ( %s < %u ) {\n", variable(g), pick(g, 100));
+            }
+            else
+            {
+                emit(g, "{\n");
+            }
+        }
+        emit_simple(g, 0);
+        for (unsigned i = depth; i > 0; i--)
+        {
+            if ((i - 1) % 2 == 0 && pick(g, 2))
+            {
+                emitf(g, "} else print %s ;\n", variable(g));
+            }
+            else
+            {
+                emit(g, "}\n");
+            }
+        }
+    }
+    else
+    {
+        emitf(g, "  %s := ", variables[2 + pick(g, 2)]);
+        emit_numexpr(g, depth, 3);
+        emit(g, " ;\n");
+    }
+    emit(g, "  return c ;\n");
+}
+
+static void emit_function(Generator *g, Shape shape, unsigned depth, int broken)
+{
+    emitf(g, "def f%zu ( int a , int b ) {\n", g->functions);
+    if (broken)
+    {
+        emit_error(g, 2);
+    }
+    emit_body(g, shape, depth);
+    emit(g, "}\n");
+    g->functions++;
+}
+
+static size_t parse_size(const char *text)
+{
+    char *end;
+    double value = strtod(text, &end);
+    switch (*end)
+    {
+    case 'k':
+    case 'K':
+        value *= 1024;
+        break;
+    case 'm':
+    case 'M':
+        value *= 1024 * 1024;
+        break;
+    case 'g':
+    case 'G':
+        value *= 1024.0 * 1024 * 1024;
+        break;
+    }
+    return value > 0 ? (size_t)value : 0;
+}
+
+static void usage(const char *program)
+{
+    fprintf(stderr,
+            "Uso: %s [-f defs|deep|expr] [-s tamanho] [-d profundidade] [-e erros] [-r semente] > programa.txt\n",
+            program);
+}
+
+int main(int argc, char *argv[])
+{
+    Shape shape = SHAPE_DEFS;
+    size_t size = 1024 * 1024;
+    unsigned depth = 100;
+    unsigned error_rate = 0;
+    uint64_t seed = 1;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (i + 1 >= argc || argv[i][0] != '-' || strlen(argv[i]) != 2)
+        {
+            usage(argv[0]);
+            return 1;
+        }
+        const char *value = argv[++i];
+        switch (argv[i - 1][1])
+        {
+        case 'f':
+            if (strcmp(value, "defs") == 0)
+            {
+                shape = SHAPE_DEFS;
+            }
+            else if (strcmp(value, "deep") == 0)
+            {
+                shape = SHAPE_DEEP;
+            }
+            else if (strcmp(value, "expr") == 0)
+            {
+                shape = SHAPE_EXPR;
+            }
+            else
+            {
+                usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 's':
+            size = parse_size(value);
+            break;
+        case 'd':
+            depth = (unsigned)atoi(value) > 0 ? (unsigned)atoi(value) : 1;
+            break;
+        case 'e':
+            error_rate = (unsigned)atoi(value);
+            break;
+        case 'r':
+            seed = strtoull(value, NULL, 10);
+            break;
+        default:
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    static char buffer[1 << 20];
+    setvbuf(stdout, buffer, _IOFBF, sizeof(buffer));
+    // A semente é misturada para que sementes pequenas e vizinhas divirjam
+    Generator g = {stdout, (seed + 1) * 0x9E3779B97F4A7C15ull, 0, 0, 0};
+
+    while (g.bytes < size || g.functions == 0)
+    {
+        int broken = error_rate > 0 && pick(&g, 1000) < error_rate;
+        emit_function(&g, shape, depth, broken);
+    }
+    if (error_rate > 0 && g.errors == 0)
+    {
+        emit_function(&g, shape, depth, 1);
+    }
+    emit(&g, "$\n");
+
+    if (fflush(stdout) != 0)
+    {
+        perror("Erro ao escrever o programa");
+        return 1;
+    }
+    fprintf(stderr, "%zu bytes, %zu funções, %zu erro(s) injetado(s)\n", g.bytes, g.functions, g.errors);
+    return 0;
+}
@@ -0,0 +1,512 @@
+#include "grammar.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Gerador da tabela LL(1): lê a gramática em BNF, calcula FIRST/FOLLOW,
+// relata conflitos e escreve table_gen.c com a tabela como dados constantes.
+// Com --direct, escreve parser_direct.c: o mesmo autômato como código.
+//
+// Uso: ./gen_table grammar.txt > table_gen.c
+//      ./gen_table --direct grammar.txt > parser_direct.c
+
+static char *read_text(const char *path)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        perror("Erro ao abrir a gramática");
+        return NULL;
+    }
+    fseek(file, 0, SEEK_END);
+    long size = ftell(file);
+    fseek(file, 0, SEEK_SET);
+    char *text = malloc((size_t)size + 1);
+    if (text != NULL && fread(text, 1, (size_t)size, file) == (size_t)size)
+    {
+        text[size] = '\0';
+    }
+    else
+    {
+        free(text);
+        text = NULL;
+    }
+    fclose(file);
+    return text;
+}
+
+// Escreve o nome do símbolo como literal C
+static void print_c_string(FILE *out, const char *s)
+{
+    fputc('"', out);
+    for (; *s; s++)
+    {
+        if (*s == '"' || *s == '\\')
+        {
+            fputc('\\', out);
+        }
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void emit_names(FILE *out, const Grammar *g, const char *decl, int first, int count)
+{
+    fprintf(out, "%s = {", decl);
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(out, "%s", (i % 8 == 0) ? "\n    " : " ");
+        print_c_string(out, g->names[first + i]);
+        fputc(',', out);
+    }
+    fprintf(out, "\n};\n\n");
+}
+
+// Procura parâmetros (a, b, c, tamanho) sem colisões para
+// h = (len * a + primeiro * b + meio * c + último) & (tamanho - 1)
+static int find_perfect_hash(const Grammar *g, int first, int count, int params[4])
+{
+    for (int size = 32; size <= 256; size *= 2)
+    {
+        if (size < count)
+        {
+            continue;
+        }
+        for (int a = 1; a < 32; a++)
+        {
+            for (int b = 1; b < 32; b++)
+            {
+                for (int c = 1; c < 32; c++)
+                {
+                    uint8_t used[256] = {0};
+                    int ok = 1;
+                    for (int i = 0; i < count && ok; i++)
+                    {
+                        const unsigned char *name = (const unsigned char *)g->names[first + i];
+                        size_t len = strlen((const char *)name);
+                        unsigned h = (unsigned)(len * a + name[0] * b + name[len / 2] * c + name[len - 1]) & (unsigned)(size - 1);
+                        ok = !used[h];
+                        used[h] = 1;
+                    }
+                    if (ok)
+                    {
+                        params[0] = a;
+                        params[1] = b;
+                        params[2] = c;
+                        params[3] = size;
+                        return 0;
+                    }
+                }
+            }
+        }
+    }
+    return -1;
+}
+
+// Emite a função de busca por hash perfeito para os nomes g->names[first .. first + count)
+static int emit_lookup(FILE *out, const Grammar *g, const char *func, const char *names, int first, int count)
+{
+    int params[4];
+    if (find_perfect_hash(g, first, count, params) != 0)
+    {
+        fprintf(stderr, "Erro: Nenhum hash perfeito encontrado para %s\n", func);
+        return -1;
+    }
+    int a = params[0], b = params[1], c = params[2], size = params[3];
+
+    uint8_t slots[256];
+    memset(slots, 0xFF, sizeof(slots));
+    for (int i = 0; i < count; i++)
+    {
+        const unsigned char *name = (const unsigned char *)g->names[first + i];
+        size_t len = strlen((const char *)name);
+        slots[(len * a + name[0] * b + name[len / 2] * c + name[len - 1]) & (unsigned)(size - 1)] = (uint8_t)i;
+    }
+
+    fprintf(out, "static const uint8_t %s_slots[%d] = {", func, size);
+    for (int i = 0; i < size; i++)
+    {
+        fprintf(out, "%s%3d,", (i % 16 == 0) ? "\n    " : " ", slots[i]);
+    }
+    fprintf(out, "\n};\n\n");
+    fprintf(out, "static const uint8_t %s_lengths[%d] = {", func, count);
+    for (int i = 0; i < count; i++)
+    {
+        fprintf(out, "%s%zu,", (i % 16 == 0) ? "\n    " : " ", strlen(g->names[first + i]));
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "int %s(const char *s, size_t len)\n{\n", func);
+    fprintf(out, "    if (len == 0)\n    {\n        return -1;\n    }\n");
+    fprintf(out, "    const unsigned char *u = (const unsigned char *)s;\n");
+    fprintf(out, "    int i = %s_slots[(len * %d + u[0] * %d + u[len / 2] * %d + u[len - 1]) & %d];\n", func, a, b, c, size - 1);
+    fprintf(out, "    if (i != 0xFF && %s_lengths[i] == len && memcmp(%s[i], s, len) == 0)\n", func, names);
+    fprintf(out, "    {\n        return i;\n    }\n    return -1;\n}\n\n");
+    return 0;
+}
+
+// Tabela de cadeias: uma por célula preenchida de prod_table
+static int emit_chains(FILE *out, const Grammar *g)
+{
+    int nterm = g->num_terminals;
+    int nt = g->num_nonterminals;
+    GrammarChain *infos = malloc((size_t)(nt * nterm) * sizeof(GrammarChain));
+    if (infos == NULL)
+    {
+        fprintf(stderr, "Erro: Falha ao alocar memória!\n");
+        return -1;
+    }
+
+    int num_chains = 0, total_symbols = 0, total_steps = 0, collapsed = 0;
+    fprintf(out, "// chain_table[não-terminal][terminal] = cadeia (válida onde prod_table tem produção)\n");
+    fprintf(out, "const uint16_t chain_table[MAX_NONTERMINALS][MAX_TERMINALS] = {\n");
+    for (int r = 0; r < nt; r++)
+    {
+        fprintf(out, "    /* %-12s */ {", g->names[nterm + r]);
+        for (int c = 0; c < nterm; c++)
+        {
+            int index = 0;
+            if (g->table[r * nterm + c] != GRAMMAR_NO_PRODUCTION)
+            {
+                index = num_chains++;
+                grammar_expand_chain(g, r, c, &infos[index]);
+                collapsed += infos[index].steps > 1 || infos[index].matches;
+            }
+            fprintf(out, "%s%3d", c ? "," : "", index);
+        }
+        fprintf(out, "},\n");
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "const Chain chains[] = {\n");
+    for (int i = 0; i < num_chains; i++)
+    {
+        const GrammarChain *c = &infos[i];
+        fprintf(out, "    {%d, %d, %d, %d, %d}, //", total_symbols, c->length, total_steps, c->steps, c->matches);
+        for (int k = 0; k < c->steps; k++)
+        {
+            fprintf(out, " %s%d", k ? "> " : "", c->productions[k]);
+        }
+        fprintf(out, "\n");
+        total_symbols += c->length;
+        total_steps += c->steps;
+    }
+    fprintf(out, "};\n\n");
+    if (total_symbols > UINT16_MAX || total_steps > UINT16_MAX)
+    {
+        fprintf(stderr, "Erro: cadeias grandes demais para índices de 16 bits\n");
+        free(infos);
+        return -1;
+    }
+
+    // Símbolos de cada cadeia em ordem inversa, prontos para empilhar
+    fprintf(out, "const symbol_t chain_symbols[] = {");
+    int col = 0;
+    for (int i = 0; i < num_chains; i++)
+    {
+        for (int k = infos[i].length - 1; k >= 0; k--)
+        {
+            fprintf(out, "%s%d,", (col++ % 16 == 0) ? "\n    " : " ", infos[i].symbols[k]);
+        }
+    }
+    fprintf(out, "%s\n};\n\n", col == 0 ? " 0" : "");
+
+    // Produções aplicadas por cada cadeia, na ordem, para o trace
+    fprintf(out, "const uint8_t chain_productions[] = {");
+    col = 0;
+    for (int i = 0; i < num_chains; i++)
+    {
+        for (int k = 0; k < infos[i].steps; k++)
+        {
+            fprintf(out, "%s%d,", (col++ % 16 == 0) ? "\n    " : " ", infos[i].productions[k]);
+        }
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(stderr, "%d cadeias, %d com mais de uma produção ou com match (%.2f produções por cadeia)\n",
+            num_chains, collapsed, num_chains ? (double)total_steps / num_chains : 0.0);
+    free(infos);
+    return 0;
+}
+
+static int emit_table(FILE *out, const Grammar *g, const char *path, uint32_t version)
+{
+    int nterm = g->num_terminals;
+    int nt = g->num_nonterminals;
+    if (nterm > 32)
+    {
+        fprintf(stderr, "Erro: follow_set comporta no máximo 32 terminais\n");
+        return -1;
+    }
+
+    fprintf(out, "// Gerado por gen_table a partir de %s. Não editar.\n", path);
+    fprintf(out, "#include \"parser.h\"\n\n");
+    fprintf(out, "_Static_assert(MAX_TERMINALS == %d, \"%s e parser.h divergem\");\n", nterm, path);
+    fprintf(out, "_Static_assert(MAX_NONTERMINALS == %d, \"%s e parser.h divergem\");\n", nt, path);
+    fprintf(out, "_Static_assert(MAX_PRODUCTIONS >= %d, \"%s e parser.h divergem\");\n\n", g->num_productions, path);
+
+    fprintf(out, "const uint32_t grammar_version = 0x%08xu;\n\n", version);
+    emit_names(out, g, "const char *const terminals[MAX_TERMINALS]", 0, nterm);
+    emit_names(out, g, "const char *const nonTerminals[MAX_NONTERMINALS]", nterm, nt);
+
+    // Símbolos de cada produção em ordem inversa, prontos para empilhar
+    fprintf(out, "const symbol_t prod_symbols[] = {");
+    int col = 0;
+    for (int p = 0; p < g->num_productions; p++)
+    {
+        const GrammarProduction *prod = &g->productions[p];
+        for (int i = prod->length - 1; i >= 0; i--)
+        {
+            fprintf(out, "%s%d,", (col++ % 16 == 0) ? "\n    " : " ", prod->rhs[i]);
+        }
+    }
+    fprintf(out, "\n};\n\n");
+
+    fprintf(out, "const int num_productions = %d;\n\n", g->num_productions);
+    fprintf(out, "const Production productions[MAX_PRODUCTIONS] = {\n");
+    int offset = 0;
+    for (int p = 0; p < g->num_productions; p++)
+    {
+        const GrammarProduction *prod = &g->productions[p];
+        char text[512];
+        grammar_production_text(g, p, text, sizeof(text));
+        fprintf(out, "    {%d, %d, N_%s, ", offset, prod->length, g->names[nterm + prod->lhs]);
+        print_c_string(out, text);
+        fprintf(out, "},\n");
+        offset += prod->length;
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "// prod_table[não-terminal][terminal] = produção, ou NO_PRODUCTION (%d)\n", GRAMMAR_NO_PRODUCTION);
+    fprintf(out, "const uint8_t prod_table[MAX_NONTERMINALS][MAX_TERMINALS] = {\n");
+    for (int r = 0; r < nt; r++)
+    {
+        fprintf(out, "    /* %-12s */ {", g->names[nterm + r]);
+        for (int c = 0; c < nterm; c++)
+        {
+            fprintf(out, "%s%3d", c ? "," : "", g->table[r * nterm + c]);
+        }
+        fprintf(out, "},\n");
+    }
+    fprintf(out, "};\n\n");
+
+    // FOLLOW como máscara de bits, usado na sincronização da recuperação de erros
+    fprintf(out, "// follow_set[não-terminal] = FOLLOW, bit t para o terminal t\n");
+    fprintf(out, "const uint32_t follow_set[MAX_NONTERMINALS] = {\n");
+    for (int r = 0; r < nt; r++)
+    {
+        fprintf(out, "    /* %-12s */ 0x%08xu,", g->names[nterm + r], (uint32_t)g->follow[r * GRAMMAR_SET_WORDS]);
+        fprintf(out, " //");
+        for (int t = 0; t < nterm; t++)
+        {
+            if ((g->follow[r * GRAMMAR_SET_WORDS + t / 64] >> (t % 64)) & 1)
+            {
+                fprintf(out, " %s", g->names[t]);
+            }
+        }
+        fprintf(out, "\n");
+    }
+    fprintf(out, "};\n\n");
+
+    // Expansões encadeadas: cada célula aplica de uma vez a sequência de
+    // produções até o primeiro match
+    if (emit_chains(out, g) != 0)
+    {
+        return -1;
+    }
+
+    // Busca de símbolos por nome em número fixo de operações
+    fprintf(out, "// Hash perfeito dos nomes: h = (len * a + primeiro * b + meio * c + último) & (tamanho - 1)\n");
+    if (emit_lookup(out, g, "terminal_lookup", "terminals", 0, nterm) != 0 ||
+        emit_lookup(out, g, "nonterminal_lookup", "nonTerminals", nterm, nt) != 0)
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Comentário com as produções de uma cadeia: "A -> x B > B -> y"
+static void print_chain_comment(FILE *out, const Grammar *g, const GrammarChain *c)
+{
+    fprintf(out, " //");
+    for (int k = 0; k < c->steps; k++)
+    {
+        char text[512];
+        const GrammarProduction *prod = &g->productions[c->productions[k]];
+        grammar_production_text(g, c->productions[k], text, sizeof(text));
+        fprintf(out, "%s %s -> %s", k ? " >" : "", g->names[g->num_terminals + prod->lhs], text[0] ? text : "ε");
+    }
+    fprintf(out, "\n");
+}
+
+// Motor direto: um case por símbolo do topo e, nos não-terminais, um case por
+// lookahead que empilha a cadeia da célula como constantes e já consome o token
+static int emit_direct(FILE *out, const Grammar *g, const char *path, uint32_t version)
+{
+    int nterm = g->num_terminals;
+    int nt = g->num_nonterminals;
+    int end = g->end_terminal;
+    GrammarChain chain;
+
+    int max_push = 2;
+    for (int r = 0; r < nt; r++)
+    {
+        for (int c = 0; c < nterm; c++)
+        {
+            if (g->table[r * nterm + c] != GRAMMAR_NO_PRODUCTION)
+            {
+                grammar_expand_chain(g, r, c, &chain);
+                max_push = chain.length > max_push ? chain.length : max_push;
+            }
+        }
+    }
+
+    fprintf(out, "// Gerado por gen_table --direct a partir de %s (versão 0x%08x). Não editar.\n", path, version);
+    fprintf(out, "#include \"parser_direct.h\"\n#include \"arena.h\"\n\n");
+    fprintf(out, "_Static_assert(MAX_TERMINALS == %d, \"%s e parser.h divergem\");\n", nterm, path);
+    fprintf(out, "_Static_assert(MAX_NONTERMINALS == %d, \"%s e parser.h divergem\");\n\n", nt, path);
+    fprintf(out, "// Maior número de símbolos empilhados num passo\n#define DIRECT_MAX_PUSH %d\n\n", max_push);
+
+    // Lookaheads com produção, por não-terminal: no fim de um trecho seguido
+    // do trecho seguinte, decide se a análise continuaria nele
+    fprintf(out, "static const uint64_t selects[%d] = {\n", nt);
+    for (int r = 0; r < nt; r++)
+    {
+        uint64_t mask = 0;
+        for (int c = 0; c < nterm && c < 64; c++)
+        {
+            if (g->table[r * nterm + c] != GRAMMAR_NO_PRODUCTION)
+            {
+                mask |= 1ull << c;
+            }
+        }
+        fprintf(out, "    /* %-12s */ 0x%016llxull,\n", g->names[nterm + r], (unsigned long long)mask);
+    }
+    fprintf(out, "};\n\n");
+
+    fprintf(out, "static int grow(DirectStack *stack, size_t needed)\n{\n");
+    fprintf(out, "    size_t capacity = stack->capacity ? stack->capacity : 256;\n");
+    fprintf(out, "    while (capacity < needed)\n    {\n        capacity *= 2;\n    }\n");
+    fprintf(out, "    symbol_t *data = counted_realloc(stack->data, capacity * sizeof(symbol_t));\n");
+    fprintf(out, "    if (data == NULL)\n    {\n        return -1;\n    }\n");
+    fprintf(out, "    stack->data = data;\n    stack->capacity = capacity;\n    return 0;\n}\n\n");
+
+    fprintf(out, "ParseStatus direct_parse(const Token *tokens, size_t begin, size_t count, int start, const Token *end_marker,\n");
+    fprintf(out, "                         DirectStack *stack, DirectError *error)\n{\n");
+    fprintf(out, "    if (stack->capacity < 256 && grow(stack, 256) != 0)\n    {\n        return PARSE_OUT_OF_MEMORY;\n    }\n");
+    fprintf(out, "    symbol_t *s = stack->data;\n    size_t top = 0;\n");
+    fprintf(out, "    s[top++] = %d; // %s\n", end, g->names[end]);
+    fprintf(out, "    s[top++] = (symbol_t)(MAX_TERMINALS + start);\n");
+    fprintf(out, "    size_t i = begin;\n\n");
+    fprintf(out, "    while (1)\n    {\n");
+    fprintf(out, "        if (top + DIRECT_MAX_PUSH > stack->capacity)\n        {\n");
+    fprintf(out, "            if (grow(stack, top + DIRECT_MAX_PUSH) != 0)\n            {\n");
+    fprintf(out, "                return PARSE_OUT_OF_MEMORY;\n            }\n");
+    fprintf(out, "            s = stack->data;\n        }\n");
+    fprintf(out, "        symbol_t x = s[--top];\n");
+    fprintf(out, "        int type = -1;\n");
+    fprintf(out, "        if (i < count)\n        {\n            type = tokens[i].type;\n        }\n");
+    fprintf(out, "        else if (end_marker != NULL)\n        {\n");
+    fprintf(out, "            type = end_marker->type;\n");
+    fprintf(out, "            // O lookahead é o início do trecho seguinte, que é analisado à parte\n");
+    fprintf(out, "            if (type != %d && type < MAX_TERMINALS && x >= MAX_TERMINALS &&\n", end);
+    fprintf(out, "                ((selects[x - MAX_TERMINALS] >> type) & 1))\n");
+    fprintf(out, "            {\n                return PARSE_ACCEPTED;\n            }\n        }\n");
+    fprintf(out, "        switch (x)\n        {\n");
+
+    fprintf(out, "        case %d: // %s\n", end, g->names[end]);
+    fprintf(out, "            return type == %d ? PARSE_ACCEPTED : PARSE_NO_END_MARKER;\n", end);
+    for (int t = 0; t < nterm; t++)
+    {
+        if (t != end)
+        {
+            fprintf(out, "        case %d: // %s\n", t, g->names[t]);
+        }
+    }
+    fprintf(out, "            if (type != x)\n            {\n");
+    fprintf(out, "                error->expected = x;\n                error->nonterminal = -1;\n");
+    fprintf(out, "                goto syntax_error;\n            }\n");
+    fprintf(out, "            i++;\n            continue;\n");
+
+    for (int r = 0; r < nt; r++)
+    {
+        fprintf(out, "        case %d: // %s\n", nterm + r, g->names[nterm + r]);
+        fprintf(out, "            switch (type)\n            {\n");
+        for (int c = 0; c < nterm; c++)
+        {
+            if (g->table[r * nterm + c] == GRAMMAR_NO_PRODUCTION)
+            {
+                continue;
+            }
+            grammar_expand_chain(g, r, c, &chain);
+            fprintf(out, "            case %d: // %s\n", c, g->names[c]);
+            fprintf(out, "               ");
+            print_chain_comment(out, g, &chain);
+            for (int k = 0; k < chain.length; k++)
+            {
+                int symbol = chain.symbols[chain.length - 1 - k];
+                fprintf(out, "                s[top + %d] = %d; // %s\n", k, symbol, g->names[symbol]);
+            }
+            if (chain.length > 0)
+            {
+                fprintf(out, "                top += %d;\n", chain.length);
+            }
+            if (chain.matches)
+            {
+                fprintf(out, "                i++;\n");
+            }
+            fprintf(out, "                continue;\n");
+        }
+        fprintf(out, "            }\n");
+        fprintf(out, "            error->expected = -1;\n            error->nonterminal = %d;\n", r);
+        fprintf(out, "            goto syntax_error;\n");
+    }
+    fprintf(out, "        default:\n            return PARSE_EMPTY_STACK;\n");
+    fprintf(out, "        }\n    }\n\n");
+    fprintf(out, "syntax_error:\n    error->index = i;\n    return PARSE_SYNTAX_ERROR;\n}\n");
+    return 0;
+}
+
+int main(int argc, char *argv[])
+{
+    int direct = argc == 3 && strcmp(argv[1], "--direct") == 0;
+    if (direct)
+    {
+        argc--;
+        argv++;
+    }
+    if (argc != 2)
+    {
+        fprintf(stderr, "Uso: %s [--direct] <gramatica.txt> > table_gen.c (ou parser_direct.c)\n", argv[0]);
+        return 1;
+    }
+
+    char *text = read_text(argv[1]);
+    if (text == NULL)
+    {
+        return 1;
+    }
+
+    Grammar g;
+    if (grammar_parse(&g, text, stderr) != 0)
+    {
+        free(text);
+        return 1;
+    }
+
+    int conflicts = grammar_build_table(&g, stderr);
+    if (conflicts < 0)
+    {
+        fprintf(stderr, "Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    fprintf(stderr, "%d terminais, %d não-terminais, %d produções, %d conflito(s) LL(1)\n",
+            g.num_terminals, g.num_nonterminals, g.num_productions, conflicts);
+
+    const char *name = strrchr(argv[1], '/');
+    int status = direct ? emit_direct(stdout, &g, name ? name + 1 : argv[1], grammar_hash(text))
+                        : emit_table(stdout, &g, name ? name + 1 : argv[1], grammar_hash(text));
+
+    grammar_free(&g);
+    free(text);
+    return status == 0 ? 0 : 1;
+}
@@ -0,0 +1,508 @@
+#include "grammar.h"
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Conjunto de terminais (até GRAMMAR_MAX_SYMBOLS) em bits
+typedef struct
+{
+    uint64_t w[4];
+} TermSet;
+
+static bool set_add(TermSet *s, int t)
+{
+    uint64_t bit = (uint64_t)1 << (t & 63);
+    if (s->w[t >> 6] & bit)
+    {
+        return false;
+    }
+    s->w[t >> 6] |= bit;
+    return true;
+}
+
+static bool set_has(const TermSet *s, int t)
+{
+    return (s->w[t >> 6] >> (t & 63)) & 1;
+}
+
+static bool set_union(TermSet *dst, const TermSet *src)
+{
+    bool changed = false;
+    for (int i = 0; i < 4; i++)
+    {
+        uint64_t merged = dst->w[i] | src->w[i];
+        changed |= merged != dst->w[i];
+        dst->w[i] = merged;
+    }
+    return changed;
+}
+
+static int find_symbol(const Grammar *g, const char *name)
+{
+    int total = g->num_terminals + g->num_nonterminals;
+    for (int i = 0; i < total; i++)
+    {
+        if (strcmp(g->names[i], name) == 0)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static int add_name(Grammar *g, const char *name, FILE *errors, int line)
+{
+    if (g->num_terminals + g->num_nonterminals >= GRAMMAR_MAX_SYMBOLS)
+    {
+        if (errors) fprintf(errors, "linha %d: gramática com símbolos demais\n", line);
+        return -1;
+    }
+    char *copy = strdup(name);
+    if (copy == NULL)
+    {
+        return -1;
+    }
+    g->names[g->num_terminals + g->num_nonterminals] = copy;
+    return 0;
+}
+
+// Divide a linha em palavras separadas por espaço; retorna a quantidade
+static int split_words(char *line, char **words, int max_words)
+{
+    int count = 0;
+    char *save = NULL;
+    for (char *w = strtok_r(line, " \t\r\n", &save); w != NULL; w = strtok_r(NULL, " \t\r\n", &save))
+    {
+        if (count == max_words)
+        {
+            return -1;
+        }
+        words[count++] = w;
+    }
+    return count;
+}
+
+// Lê a gramática em BNF. Retorna 0 em caso de sucesso e -1 em caso de erro,
+// descrevendo o problema em 'errors' (se não for NULL).
+int grammar_parse(Grammar *g, const char *text, FILE *errors)
+{
+    memset(g, 0, sizeof(*g));
+    g->end_terminal = -1;
+
+    char *copy = strdup(text);
+    if (copy == NULL)
+    {
+        return -1;
+    }
+
+    // Primeira passada: terminais e não-terminais, na ordem de declaração.
+    // Segunda passada: produções, já com todos os símbolos conhecidos.
+    int capacity = 0;
+    int line_no = 0;
+    bool ok = true;
+    char *words[512];
+    for (int pass = 0; pass < 2 && ok; pass++)
+    {
+        strcpy(copy, text);
+        int lhs = -1;
+        line_no = 0;
+        for (char *line = copy, *next; line != NULL && ok; line = next)
+        {
+            next = strchr(line, '\n');
+            if (next != NULL)
+            {
+                *next++ = '\0';
+            }
+            line_no++;
+            int n = split_words(line, words, 512);
+            if (n < 0)
+            {
+                if (errors) fprintf(errors, "linha %d: linha longa demais\n", line_no);
+                ok = false;
+                break;
+            }
+            if (n == 0 || words[0][0] == '#')
+            {
+                continue;
+            }
+
+            int first_alt;
+            if (strcmp(words[0], "%token") == 0)
+            {
+                if (pass == 0)
+                {
+                    if (g->num_nonterminals > 0)
+                    {
+                        if (errors) fprintf(errors, "linha %d: %%token deve vir antes das regras\n", line_no);
+                        ok = false;
+                    }
+                    for (int i = 1; i < n && ok; i++)
+                    {
+                        if (find_symbol(g, words[i]) != -1)
+                        {
+                            if (errors) fprintf(errors, "linha %d: terminal '%s' repetido\n", line_no, words[i]);
+                            ok = false;
+                        }
+                        else if (add_name(g, words[i], errors, line_no) != 0)
+                        {
+                            ok = false;
+                        }
+                        else
+                        {
+                            g->num_terminals++;
+                        }
+                    }
+                }
+                continue;
+            }
+            else if (n >= 2 && strcmp(words[1], "::=") == 0)
+            {
+                if (pass == 0)
+                {
+                    int sym = find_symbol(g, words[0]);
+                    if (sym != -1 && sym < g->num_terminals)
+                    {
+                        if (errors) fprintf(errors, "linha %d: terminal '%s' usado como não-terminal\n", line_no, words[0]);
+                        ok = false;
+                    }
+                    else if (sym == -1)
+                    {
+                        if (add_name(g, words[0], errors, line_no) != 0)
+                        {
+                            ok = false;
+                        }
+                        else
+                        {
+                            g->num_nonterminals++;
+                        }
+                    }
+                    continue;
+                }
+                lhs = find_symbol(g, words[0]) - g->num_terminals;
+                first_alt = 2;
+            }
+            else if (strcmp(words[0], "|") == 0 && (pass == 0 || lhs != -1))
+            {
+                if (pass == 0)
+                {
+                    continue;
+                }
+                first_alt = 1;
+            }
+            else
+            {
+                if (errors) fprintf(errors, "linha %d: esperava 'A ::= ...', '| ...' ou '%%token'\n", line_no);
+                ok = false;
+                break;
+            }
+
+            // Alternativas separadas por '|'
+            int start = first_alt;
+            for (int i = first_alt; i <= n && ok; i++)
+            {
+                if (i < n && strcmp(words[i], "|") != 0)
+                {
+                    continue;
+                }
+
+                if (g->num_productions == capacity)
+                {
+                    capacity = capacity ? capacity * 2 : 64;
+                    GrammarProduction *prods = realloc(g->productions, capacity * sizeof(GrammarProduction));
+                    if (prods == NULL)
+                    {
+                        ok = false;
+                        break;
+                    }
+                    g->productions = prods;
+                }
+                GrammarProduction *prod = &g->productions[g->num_productions];
+                prod->lhs = (uint8_t)lhs;
+                prod->length = 0;
+
+                for (int j = start; j < i && ok; j++)
+                {
+                    if (strcmp(words[j], "''") == 0)
+                    {
+                        continue;
+                    }
+                    int sym = find_symbol(g, words[j]);
+                    if (sym == -1)
+                    {
+                        if (errors) fprintf(errors, "linha %d: símbolo '%s' não declarado\n", line_no, words[j]);
+                        ok = false;
+                    }
+                    else if (prod->length == GRAMMAR_MAX_RHS)
+                    {
+                        if (errors) fprintf(errors, "linha %d: produção longa demais\n", line_no);
+                        ok = false;
+                    }
+                    else
+                    {
+                        prod->rhs[prod->length++] = (uint8_t)sym;
+                    }
+                }
+                if (ok && g->num_productions == GRAMMAR_NO_PRODUCTION)
+                {
+                    if (errors) fprintf(errors, "linha %d: gramática com produções demais\n", line_no);
+                    ok = false;
+                }
+                g->num_productions++;
+                start = i + 1;
+            }
+        }
+
+        if (pass == 0 && ok)
+        {
+            g->end_terminal = find_symbol(g, "$");
+            if (g->end_terminal == -1 || g->end_terminal >= g->num_terminals)
+            {
+                if (errors) fprintf(errors, "gramática sem o terminal '$'\n");
+                ok = false;
+            }
+            else if (g->num_nonterminals == 0)
+            {
+                if (errors) fprintf(errors, "gramática sem regras\n");
+                ok = false;
+            }
+        }
+    }
+
+    free(copy);
+    if (!ok)
+    {
+        grammar_free(g);
+        return -1;
+    }
+    return 0;
+}
+
+// FIRST de rhs[from..length); retorna true se a sequência deriva ε
+static bool first_of_sequence(const Grammar *g, const uint8_t *rhs, int length, const TermSet *first,
+                              const bool *nullable, TermSet *out)
+{
+    for (int i = 0; i < length; i++)
+    {
+        int sym = rhs[i];
+        if (sym < g->num_terminals)
+        {
+            set_add(out, sym);
+            return false;
+        }
+        set_union(out, &first[sym - g->num_terminals]);
+        if (!nullable[sym - g->num_terminals])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Calcula FIRST/FOLLOW e preenche g->table. Conflitos LL(1) são descritos em
+// 'report' e resolvidos a favor da produção declarada primeiro (o que dá ao
+// 'else' pendente o if mais próximo). Retorna o número de conflitos ou -1.
+int grammar_build_table(Grammar *g, FILE *report)
+{
+    int nt = g->num_nonterminals;
+    int nterm = g->num_terminals;
+
+    bool *nullable = calloc(nt, sizeof(bool));
+    TermSet *first = calloc(nt, sizeof(TermSet));
+    TermSet *follow = calloc(nt, sizeof(TermSet));
+    free(g->table);
+    g->table = malloc((size_t)nt * nterm);
+    if (nullable == NULL || first == NULL || follow == NULL || g->table == NULL)
+    {
+        free(nullable);
+        free(first);
+        free(follow);
+        return -1;
+    }
+    memset(g->table, GRAMMAR_NO_PRODUCTION, (size_t)nt * nterm);
+
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int p = 0; p < g->num_productions; p++)
+        {
+            const GrammarProduction *prod = &g->productions[p];
+            TermSet seq = {{0}};
+            bool seq_nullable = first_of_sequence(g, prod->rhs, prod->length, first, nullable, &seq);
+            changed |= set_union(&first[prod->lhs], &seq);
+            if (seq_nullable && !nullable[prod->lhs])
+            {
+                nullable[prod->lhs] = true;
+                changed = true;
+            }
+        }
+    }
+
+    set_add(&follow[0], g->end_terminal);
+    changed = true;
+    while (changed)
+    {
+        changed = false;
+        for (int p = 0; p < g->num_productions; p++)
+        {
+            const GrammarProduction *prod = &g->productions[p];
+            for (int i = 0; i < prod->length; i++)
+            {
+                int sym = prod->rhs[i];
+                if (sym < nterm)
+                {
+                    continue;
+                }
+                TermSet rest = {{0}};
+                bool rest_nullable = first_of_sequence(g, &prod->rhs[i + 1], prod->length - i - 1, first, nullable, &rest);
+                changed |= set_union(&follow[sym - nterm], &rest);
+                if (rest_nullable)
+                {
+                    changed |= set_union(&follow[sym - nterm], &follow[prod->lhs]);
+                }
+            }
+        }
+    }
+
+    int conflicts = 0;
+    for (int p = 0; p < g->num_productions; p++)
+    {
+        const GrammarProduction *prod = &g->productions[p];
+        TermSet predict = {{0}};
+        if (first_of_sequence(g, prod->rhs, prod->length, first, nullable, &predict))
+        {
+            set_union(&predict, &follow[prod->lhs]);
+        }
+
+        for (int t = 0; t < nterm; t++)
+        {
+            if (!set_has(&predict, t))
+            {
+                continue;
+            }
+            uint8_t *cell = &g->table[prod->lhs * nterm + t];
+            if (*cell == GRAMMAR_NO_PRODUCTION)
+            {
+                *cell = (uint8_t)p;
+                continue;
+            }
+
+            conflicts++;
+            if (report)
+            {
+                char kept[256], dropped[256];
+                grammar_production_text(g, *cell, kept, sizeof(kept));
+                grammar_production_text(g, p, dropped, sizeof(dropped));
+                fprintf(report, "Conflito LL(1) em [%s, %s]: '%s -> %s' x '%s -> %s' (mantida a primeira)\n",
+                        g->names[nterm + prod->lhs], g->names[t],
+                        g->names[nterm + prod->lhs], kept[0] ? kept : "ε",
+                        g->names[nterm + prod->lhs], dropped[0] ? dropped : "ε");
+            }
+        }
+    }
+
+    // Guarda FOLLOW para a recuperação de erros do parser
+    free(g->follow);
+    g->follow = calloc((size_t)nt * GRAMMAR_SET_WORDS, sizeof(uint64_t));
+    if (g->follow == NULL)
+    {
+        free(nullable);
+        free(first);
+        free(follow);
+        return -1;
+    }
+    for (int a = 0; a < nt; a++)
+    {
+        memcpy(&g->follow[a * GRAMMAR_SET_WORDS], follow[a].w, sizeof(follow[a].w));
+    }
+
+    free(nullable);
+    free(first);
+    free(follow);
+    return conflicts;
+}
+
+// Veja GrammarChain em grammar.h
+void grammar_expand_chain(const Grammar *g, int row, int col, GrammarChain *c)
+{
+    int nterm = g->num_terminals;
+    c->length = 0;
+    c->steps = 0;
+    c->matches = 0;
+    int p = g->table[row * nterm + col];
+    while (1)
+    {
+        const GrammarProduction *prod = &g->productions[p];
+        if (c->steps == GRAMMAR_MAX_CHAIN_STEPS || c->length + prod->length > GRAMMAR_MAX_CHAIN_LENGTH)
+        {
+            break; // não acontece numa gramática LL(1) sem recursão à esquerda
+        }
+        // Troca o primeiro símbolo (já expandido) pelo lado direito de p
+        memmove(c->symbols + prod->length, c->symbols + (c->steps > 0), (size_t)(c->length - (c->steps > 0)));
+        memcpy(c->symbols, prod->rhs, prod->length);
+        c->length += prod->length - (c->steps > 0);
+        c->productions[c->steps++] = (uint8_t)p;
+
+        if (c->length == 0)
+        {
+            return;
+        }
+        int first = c->symbols[0];
+        if (first < nterm)
+        {
+            if (first == col)
+            {
+                memmove(c->symbols, c->symbols + 1, (size_t)--c->length);
+                c->matches = 1;
+            }
+            return;
+        }
+        p = g->table[(first - nterm) * nterm + col];
+        if (p == GRAMMAR_NO_PRODUCTION)
+        {
+            return;
+        }
+    }
+}
+
+// Escreve o lado direito da produção p ("" para ε); retorna o tamanho do texto
+int grammar_production_text(const Grammar *g, int p, char *buf, size_t size)
+{
+    const GrammarProduction *prod = &g->productions[p];
+    size_t used = 0;
+    buf[0] = '\0';
+    for (int i = 0; i < prod->length; i++)
+    {
+        int n = snprintf(buf + used, size - used, "%s%s", i > 0 ? " " : "", g->names[prod->rhs[i]]);
+        if (n < 0 || (size_t)n >= size - used)
+        {
+            break;
+        }
+        used += (size_t)n;
+    }
+    return (int)used;
+}
+
+// Hash FNV-1a do texto da gramática, usado como versão da tabela gerada
+uint32_t grammar_hash(const char *text)
+{
+    uint32_t h = 2166136261u;
+    for (const unsigned char *c = (const unsigned char *)text; *c; c++)
+    {
+        h ^= *c;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void grammar_free(Grammar *g)
+{
+    for (int i = 0; i < g->num_terminals + g->num_nonterminals; i++)
+    {
+        free(g->names[i]);
+    }
+    free(g->productions);
+    free(g->table);
+    free(g->follow);
+    memset(g, 0, sizeof(*g));
+}
@@ -0,0 +1,63 @@
+#ifndef GRAMMAR_H
+#define GRAMMAR_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+// Gramática lida de um arquivo BNF e tabela LL(1) calculada a partir dela.
+// Símbolos: terminais em [0, num_terminals), não-terminais logo em seguida.
+
+#define GRAMMAR_MAX_SYMBOLS 254
+#define GRAMMAR_MAX_RHS 16
+#define GRAMMAR_NO_PRODUCTION 0xFF
+#define GRAMMAR_SET_WORDS 4 // palavras de 64 bits por conjunto de terminais
+
+typedef struct
+{
+    uint8_t lhs; // índice do não-terminal
+    uint8_t length;
+    uint8_t rhs[GRAMMAR_MAX_RHS];
+} GrammarProduction;
+
+typedef struct
+{
+    char *names[GRAMMAR_MAX_SYMBOLS];
+    int num_terminals;
+    int num_nonterminals;
+    int end_terminal; // índice de '$'
+
+    GrammarProduction *productions;
+    int num_productions;
+
+    // table[nt * num_terminals + t] = índice da produção ou GRAMMAR_NO_PRODUCTION
+    uint8_t *table;
+
+    // FOLLOW de cada não-terminal: bit t de follow[nt * GRAMMAR_SET_WORDS + t / 64]
+    uint64_t *follow;
+} Grammar;
+
+#define GRAMMAR_MAX_CHAIN_STEPS 64
+#define GRAMMAR_MAX_CHAIN_LENGTH 255
+
+// Cadeia de expansões de (não-terminal, lookahead): aplica a produção da
+// tabela e segue expandindo o símbolo mais à esquerda com o mesmo lookahead
+// até chegar a um terminal (que é o próprio lookahead e já é consumido), a
+// uma forma vazia ou a uma célula vazia (o erro fica para a execução).
+// symbols recebe a forma resultante da esquerda para a direita.
+typedef struct
+{
+    uint8_t symbols[GRAMMAR_MAX_CHAIN_LENGTH];
+    int length;
+    uint8_t productions[GRAMMAR_MAX_CHAIN_STEPS];
+    int steps;
+    int matches;
+} GrammarChain;
+
+int grammar_parse(Grammar *g, const char *text, FILE *errors);
+int grammar_build_table(Grammar *g, FILE *report);
+void grammar_expand_chain(const Grammar *g, int row, int col, GrammarChain *c);
+int grammar_production_text(const Grammar *g, int p, char *buf, size_t size);
+uint32_t grammar_hash(const char *text);
+void grammar_free(Grammar *g);
+
+#endif
@@ -0,0 +1,569 @@
+#include "incremental.h"
+#include "arena.h"
+#include "source.h"
+
+// Trecho do documento: uma função (ou o documento inteiro, se ele não começar
+// com 'def'). Os offsets dos tokens e do resultado são relativos ao trecho.
+typedef struct
+{
+    char *text;
+    size_t length;
+    TokenArray tokens;
+    ParseResult result;
+    int lines_counted; // newlines só é contado quando um diagnóstico pede a linha
+    size_t newlines;
+} Segment;
+
+// Somas de prefixo por trecho (árvores de Fenwick, índices a partir de 1):
+// localizar o trecho de um offset e converter posições relativas em globais
+// custa O(log n) e não exige deslocar nada quando um trecho muda de tamanho
+struct Document
+{
+    Segment *segments;
+    size_t count;
+    size_t capacity;
+    size_t *text_index;  // bytes por trecho
+    size_t *token_index; // tokens por trecho
+    size_t *error_index; // 1 se o trecho foi rejeitado
+    size_t length;
+    size_t num_tokens;
+    size_t num_errors;
+    size_t reparsed;
+    Parser *parser;
+};
+
+static void fenwick_add(size_t *tree, size_t n, size_t i, size_t delta)
+{
+    for (i++; i <= n; i += i & -i)
+    {
+        tree[i] += delta; // delta "negativo" funciona pela aritmética modular
+    }
+}
+
+// Soma dos elementos [0, i)
+static size_t fenwick_prefix(const size_t *tree, size_t i)
+{
+    size_t sum = 0;
+    for (; i > 0; i -= i & -i)
+    {
+        sum += tree[i];
+    }
+    return sum;
+}
+
+// Maior i com soma de [0, i) <= pos, isto é, o elemento que contém pos
+static size_t fenwick_find(const size_t *tree, size_t n, size_t pos)
+{
+    size_t step = 1;
+    while (step * 2 <= n)
+    {
+        step *= 2;
+    }
+    size_t i = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (i + step <= n && tree[i + step] <= pos)
+        {
+            i += step;
+            pos -= tree[i];
+        }
+    }
+    return i;
+}
+
+static int is_rejected(const Segment *s)
+{
+    return s->result.status != PARSE_ACCEPTED;
+}
+
+// Reconstrói as três árvores em O(n), depois que trechos entram ou saem
+static void rebuild_index(Document *d)
+{
+    size_t n = d->count;
+    memset(d->text_index, 0, (n + 1) * sizeof(size_t));
+    memset(d->token_index, 0, (n + 1) * sizeof(size_t));
+    memset(d->error_index, 0, (n + 1) * sizeof(size_t));
+    for (size_t i = 1; i <= n; i++)
+    {
+        const Segment *s = &d->segments[i - 1];
+        d->text_index[i] += s->length;
+        d->token_index[i] += s->tokens.count;
+        d->error_index[i] += (size_t)is_rejected(s);
+        size_t parent = i + (i & -i);
+        if (parent <= n)
+        {
+            d->text_index[parent] += d->text_index[i];
+            d->token_index[parent] += d->token_index[i];
+            d->error_index[parent] += d->error_index[i];
+        }
+    }
+}
+
+static size_t segment_at(const Document *d, size_t offset)
+{
+    size_t i = fenwick_find(d->text_index, d->count, offset);
+    return i < d->count ? i : d->count - 1;
+}
+
+static int reserve_segments(Document *d, size_t count)
+{
+    if (count <= d->capacity)
+    {
+        return 0;
+    }
+    size_t capacity = d->capacity * 2 > count ? d->capacity * 2 : count;
+    Segment *segments = counted_realloc(d->segments, capacity * sizeof(Segment));
+    if (segments == NULL)
+    {
+        return -1;
+    }
+    d->segments = segments;
+    size_t **trees[] = {&d->text_index, &d->token_index, &d->error_index};
+    for (int k = 0; k < 3; k++)
+    {
+        size_t *tree = counted_realloc(*trees[k], (capacity + 1) * sizeof(size_t));
+        if (tree == NULL)
+        {
+            return -1; // capacity não muda: as árvores que cresceram só sobram
+        }
+        *trees[k] = tree;
+    }
+    d->capacity = capacity;
+    return 0;
+}
+
+static void free_segment(Segment *s)
+{
+    free(s->text);
+    token_array_free(&s->tokens);
+}
+
+// O último trecho é analisado como o programa inteiro (a partir de S, com o
+// '$' real); os outros como FLIST, seguidos do 'def' que abre o trecho
+// seguinte. Com esse lookahead, as produções escolhidas no fim do trecho e o
+// diagnóstico de um erro ali (token, terminal esperado, não-terminal) são os
+// da análise do documento inteiro.
+static void parse_segment(Document *d, Segment *s, int last)
+{
+    if (last)
+    {
+        parser_parse_tokens(d->parser, s->text, &s->tokens);
+        s->result = *parser_result(d->parser);
+        return;
+    }
+    Token next = {(uint32_t)s->length, 3, T_DEF};
+    parser_parse_range(d->parser, s->text, &s->tokens, 0, s->tokens.count, N_FLIST, &next);
+    s->result = *parser_result(d->parser);
+}
+
+// Copia os bytes [from, to) do documento; from está no trecho k ou depois
+static char *copy_span(const Document *d, size_t k, size_t from, size_t to, char *dst)
+{
+    size_t pos = fenwick_prefix(d->text_index, k);
+    for (; from < to; k++)
+    {
+        const Segment *s = &d->segments[k];
+        size_t a = from - pos;
+        size_t b = to - pos < s->length ? to - pos : s->length;
+        if (a < b)
+        {
+            memcpy(dst, s->text + a, b - a);
+            dst += b - a;
+            from = pos + b;
+        }
+        pos += s->length;
+    }
+    return dst;
+}
+
+static int has_end_marker(const TokenArray *tokens)
+{
+    for (size_t i = 0; i < tokens->count; i++)
+    {
+        if (tokens->tokens[i].type == T_END)
+        {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Divide o texto relexado da região nos trechos novos: um por 'def' (se a
+// região começar com 'def'), ou um só. A análise termina no primeiro '$', e
+// o que vem depois dele fica no último trecho. Em caso de sucesso, text e
+// tokens passam a pertencer aos trechos.
+static Segment *split_region(char *text, size_t len, TokenArray *tokens, size_t *count)
+{
+    size_t n = 1;
+    if (tokens->count > 0 && tokens->tokens[0].type == T_DEF)
+    {
+        for (size_t i = 1; i < tokens->count && tokens->tokens[i].type != T_END; i++)
+        {
+            n += tokens->tokens[i].type == T_DEF;
+        }
+    }
+    Segment *fresh = counted_malloc(n * sizeof(Segment));
+    if (fresh == NULL)
+    {
+        return NULL;
+    }
+    if (n == 1)
+    {
+        fresh[0] = (Segment){text, len, *tokens, {0}, 0, 0};
+        *count = 1;
+        return fresh;
+    }
+
+    size_t t = 0;
+    for (size_t j = 0; j < n; j++)
+    {
+        size_t t_end = t + 1;
+        while (t_end < tokens->count && (j == n - 1 || tokens->tokens[t_end].type != T_DEF))
+        {
+            t_end++;
+        }
+        size_t begin = j == 0 ? 0 : tokens->tokens[t].offset;
+        size_t end = t_end < tokens->count ? tokens->tokens[t_end].offset : len;
+        Segment *s = &fresh[j];
+        memset(s, 0, sizeof(*s));
+        s->length = end - begin;
+        s->text = counted_malloc(s->length ? s->length : 1);
+        s->tokens.count = s->tokens.capacity = t_end - t;
+        s->tokens.tokens = counted_malloc(s->tokens.count * sizeof(Token));
+        if (s->text == NULL || s->tokens.tokens == NULL)
+        {
+            for (size_t k = 0; k <= j; k++)
+            {
+                free_segment(&fresh[k]);
+            }
+            free(fresh);
+            return NULL;
+        }
+        memcpy(s->text, text + begin, s->length);
+        for (size_t k = 0; k < s->tokens.count; k++)
+        {
+            s->tokens.tokens[k] = tokens->tokens[t + k];
+            s->tokens.tokens[k].offset -= (uint32_t)begin;
+        }
+        t = t_end;
+    }
+    free(text);
+    token_array_free(tokens);
+    *count = n;
+    return fresh;
+}
+
+int document_edit(Document *d, size_t offset, size_t removed, const char *text, size_t inserted)
+{
+    if (offset > d->length || removed > d->length - offset || d->length - removed + inserted > UINT32_MAX)
+    {
+        return -1;
+    }
+
+    // Região afetada: do trecho com o byte antes da edição ao trecho com o
+    // byte depois dela, para que lexemas colados nas bordas sejam refeitos.
+    // Ela cresce até começar com 'def' (ou cobrir o documento inteiro).
+    size_t end = offset + removed;
+    size_t first = offset > 0 ? segment_at(d, offset - 1) : 0;
+    size_t last = segment_at(d, end);
+    char *buf = NULL;
+    size_t len;
+    TokenArray tokens = {0};
+    while (1)
+    {
+        size_t begin = fenwick_prefix(d->text_index, first);
+        size_t region_end = fenwick_prefix(d->text_index, last + 1);
+        len = region_end - begin - removed + inserted;
+        char *bigger = counted_realloc(buf, len ? len : 1);
+        if (bigger == NULL)
+        {
+            free(buf);
+            token_array_free(&tokens);
+            return -1;
+        }
+        buf = bigger;
+        char *dst = copy_span(d, first, begin, offset, buf);
+        memcpy(dst, text, inserted);
+        copy_span(d, first, end, region_end, dst + inserted);
+
+        if (tokenize_input(buf, len, &tokens) != 0)
+        {
+            free(buf);
+            token_array_free(&tokens);
+            return -1;
+        }
+        int starts_with_def = tokens.count > 0 && tokens.tokens[0].type == T_DEF;
+        int whole = first == 0 && last == d->count - 1;
+        if (last < d->count - 1 && has_end_marker(&tokens))
+        {
+            last = d->count - 1; // tudo depois de um '$' fica no último trecho
+        }
+        else if (starts_with_def || whole)
+        {
+            break;
+        }
+        else if (first > 0)
+        {
+            first--; // a região perdeu o 'def' inicial: junta com o trecho anterior
+        }
+        else if (tokens.count == 0)
+        {
+            last++; // só espaços no início: o primeiro 'def' está no trecho seguinte
+        }
+        else
+        {
+            last = d->count - 1; // o documento não começa com 'def'
+        }
+    }
+
+    size_t reparsed = tokens.count;
+    size_t num_new;
+    Segment *fresh = split_region(buf, len, &tokens, &num_new);
+    size_t num_old = last - first + 1;
+    if (fresh == NULL || reserve_segments(d, d->count - num_old + num_new) != 0)
+    {
+        if (fresh != NULL)
+        {
+            for (size_t j = 0; j < num_new; j++)
+            {
+                free_segment(&fresh[j]);
+            }
+            free(fresh);
+        }
+        else
+        {
+            free(buf);
+            token_array_free(&tokens);
+        }
+        return -1;
+    }
+    int ends_document = last == d->count - 1;
+    for (size_t j = 0; j < num_new; j++)
+    {
+        parse_segment(d, &fresh[j], ends_document && j == num_new - 1);
+    }
+
+    for (size_t i = first; i <= last; i++)
+    {
+        Segment *s = &d->segments[i];
+        d->length -= s->length;
+        d->num_tokens -= s->tokens.count;
+        d->num_errors -= (size_t)is_rejected(s);
+    }
+    for (size_t j = 0; j < num_new; j++)
+    {
+        d->length += fresh[j].length;
+        d->num_tokens += fresh[j].tokens.count;
+        d->num_errors += (size_t)is_rejected(&fresh[j]);
+    }
+
+    if (num_new == num_old)
+    {
+        // Caso comum (edição dentro de uma função): atualização pontual
+        for (size_t j = 0; j < num_new; j++)
+        {
+            Segment *s = &d->segments[first + j];
+            fenwick_add(d->text_index, d->count, first + j, fresh[j].length - s->length);
+            fenwick_add(d->token_index, d->count, first + j, fresh[j].tokens.count - s->tokens.count);
+            fenwick_add(d->error_index, d->count, first + j,
+                        (size_t)is_rejected(&fresh[j]) - (size_t)is_rejected(s));
+            free_segment(s);
+            *s = fresh[j];
+        }
+    }
+    else
+    {
+        // Funções criadas ou removidas: desloca o resto e refaz os índices.
+        // É O(número de funções), não O(log n): a árvore de Fenwick não
+        // insere posições, e o vetor de trechos é contíguo (limitação
+        // conhecida, medida no README)
+        for (size_t i = first; i <= last; i++)
+        {
+            free_segment(&d->segments[i]);
+        }
+        memmove(&d->segments[first + num_new], &d->segments[last + 1], (d->count - last - 1) * sizeof(Segment));
+        memcpy(&d->segments[first], fresh, num_new * sizeof(Segment));
+        d->count = d->count - num_old + num_new;
+        rebuild_index(d);
+    }
+    free(fresh);
+    d->reparsed = reparsed;
+    return 0;
+}
+
+Document *document_create(const char *src, size_t len)
+{
+    Document *d = counted_malloc(sizeof(Document));
+    if (d == NULL)
+    {
+        return NULL;
+    }
+    memset(d, 0, sizeof(*d));
+    d->parser = parser_create();
+    if (d->parser == NULL || reserve_segments(d, 16) != 0)
+    {
+        document_destroy(d);
+        return NULL;
+    }
+    // Começa com um trecho vazio e insere o texto inteiro como uma edição
+    memset(&d->segments[0], 0, sizeof(Segment));
+    d->segments[0].result.status = PARSE_ACCEPTED;
+    d->count = 1;
+    rebuild_index(d);
+    if (document_edit(d, 0, 0, src, len) != 0)
+    {
+        document_destroy(d);
+        return NULL;
+    }
+    return d;
+}
+
+static size_t first_rejected(const Document *d)
+{
+    return d->num_errors > 0 ? fenwick_find(d->error_index, d->count, 0) : d->count;
+}
+
+ParseStatus document_status(const Document *d)
+{
+    size_t i = first_rejected(d);
+    return i < d->count ? d->segments[i].result.status : PARSE_ACCEPTED;
+}
+
+ParseStatus document_first_error(const Document *d, ParseResult *out)
+{
+    size_t i = first_rejected(d);
+    if (i == d->count)
+    {
+        memset(out, 0, sizeof(*out));
+        out->expected = -1;
+        out->nonterminal = -1;
+        return PARSE_ACCEPTED;
+    }
+    *out = d->segments[i].result;
+    out->token_index += fenwick_prefix(d->token_index, i);
+    if (out->has_token)
+    {
+        out->offset += (uint32_t)fenwick_prefix(d->text_index, i);
+    }
+    return out->status;
+}
+
+int document_message(const Document *d, char *buf, size_t size)
+{
+    size_t i = first_rejected(d);
+    if (i == d->count)
+    {
+        ParseResult accepted = {0};
+        return parse_result_message(&accepted, NULL, buf, size);
+    }
+    const Segment *s = &d->segments[i];
+    return parse_result_message(&s->result, s->text, buf, size);
+}
+
+static size_t segment_newlines(Segment *s)
+{
+    if (!s->lines_counted)
+    {
+        s->newlines = 0;
+        for (const char *p = s->text, *end = s->text + s->length; (p = memchr(p, '\n', (size_t)(end - p))) != NULL; p++)
+        {
+            s->newlines++;
+        }
+        s->lines_counted = 1;
+    }
+    return s->newlines;
+}
+
+// Linha e coluna do primeiro erro. Só os trechos antes dele são percorridos,
+// e só na primeira vez: o número de quebras de linha de cada trecho fica
+// guardado até uma edição substituí-lo. Retorna -1 se não houver erro.
+int document_error_position(Document *d, SourcePosition *pos)
+{
+    size_t i = first_rejected(d);
+    if (i == d->count)
+    {
+        return -1;
+    }
+    size_t line = 0;
+    for (size_t k = 0; k < i; k++)
+    {
+        line += segment_newlines(&d->segments[k]);
+    }
+
+    const Segment *s = &d->segments[i];
+    size_t offset = s->result.offset < s->length ? s->result.offset : s->length;
+    size_t start = 0; // início da linha dentro do trecho
+    for (const char *p = s->text; (p = memchr(p, '\n', (size_t)(s->text + offset - p))) != NULL; p++)
+    {
+        line++;
+        start = (size_t)(p - s->text) + 1;
+    }
+    size_t column = source_count_chars(s->text + start, offset - start);
+    size_t line_start = fenwick_prefix(d->text_index, i) + start;
+    if (start == 0)
+    {
+        // A linha começa num trecho anterior (ex.: "} def" na mesma linha)
+        for (size_t k = i; k-- > 0;)
+        {
+            const Segment *prev = &d->segments[k];
+            size_t from = prev->length;
+            while (from > 0 && prev->text[from - 1] != '\n')
+            {
+                from--;
+            }
+            column += source_count_chars(prev->text + from, prev->length - from);
+            line_start -= prev->length - from;
+            if (from > 0)
+            {
+                break;
+            }
+        }
+    }
+    pos->line = (uint32_t)(line + 1);
+    pos->column = (uint32_t)(column + 1);
+    pos->line_start = line_start;
+    return 0;
+}
+
+size_t document_length(const Document *d)
+{
+    return d->length;
+}
+
+size_t document_function_count(const Document *d)
+{
+    return d->count;
+}
+
+size_t document_token_count(const Document *d)
+{
+    return d->num_tokens;
+}
+
+size_t document_reparsed_tokens(const Document *d)
+{
+    return d->reparsed;
+}
+
+void document_copy_text(const Document *d, char *buf)
+{
+    copy_span(d, 0, 0, d->length, buf);
+}
+
+void document_destroy(Document *d)
+{
+    if (d == NULL)
+    {
+        return;
+    }
+    for (size_t i = 0; i < d->count; i++)
+    {
+        free_segment(&d->segments[i]);
+    }
+    free(d->segments);
+    free(d->text_index);
+    free(d->token_index);
+    free(d->error_index);
+    parser_destroy(d->parser);
+    free(d);
+}
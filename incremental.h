@@ -0,0 +1,46 @@
+#ifndef INCREMENTAL_H
+#define INCREMENTAL_H
+
+#include "lexer.h"
+#include "source.h"
+
+// Documento editável com reanálise incremental. O texto é guardado em
+// trechos, um por função: cada 'def' inicia um trecho (na gramática, 'def'
+// só começa um FDEF), e o primeiro trecho inclui os espaços iniciais. Uma
+// edição relexa e reanalisa só os trechos que ela toca; os demais mantêm
+// tokens e resultado. Documentos que não começam com 'def' ficam num único
+// trecho, analisado inteiro a cada edição.
+typedef struct Document Document;
+
+// Cria o documento com uma cópia de src e o analisa; NULL se faltar memória
+// ou se o texto passar de 4 GiB
+Document *document_create(const char *src, size_t len);
+
+// Substitui removed bytes a partir de offset por text[0 .. inserted).
+// Retorna 0, ou -1 se o intervalo for inválido ou faltar memória (nesses
+// casos o documento não muda).
+int document_edit(Document *d, size_t offset, size_t removed, const char *text, size_t inserted);
+
+// Veredito do documento inteiro, o mesmo de parser_parse_buffer sobre o texto
+ParseStatus document_status(const Document *d);
+
+// Primeiro erro do documento, com token_index e offset globais; devolve o
+// status (PARSE_ACCEPTED se não houver erro)
+ParseStatus document_first_error(const Document *d, ParseResult *out);
+int document_message(const Document *d, char *buf, size_t size);
+
+// Linha e coluna do primeiro erro, calculadas sob demanda; -1 se não houver erro
+int document_error_position(Document *d, SourcePosition *pos);
+
+size_t document_length(const Document *d);
+size_t document_function_count(const Document *d);
+size_t document_token_count(const Document *d);
+
+// Tokens relexados e reanalisados pela última edição
+size_t document_reparsed_tokens(const Document *d);
+
+// Copia o texto atual para buf (document_length(d) bytes)
+void document_copy_text(const Document *d, char *buf);
+void document_destroy(Document *d);
+
+#endif
@@ -0,0 +1,562 @@
+#include "lexer.h"
+#include "arena.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <unistd.h>
+
+// Retorna o terminal da palavra reservada ou -1 se o lexema não for reservado.
+// Decide pelo tamanho e pelo primeiro caractere; no máximo uma comparação.
+int reserved_word_type(const char *word, size_t len)
+{
+    switch (len)
+    {
+    case 2:
+        return (word[0] == 'i' && word[1] == 'f') ? T_IF : -1;
+    case 3:
+        if (word[0] == 'i')
+        {
+            return (word[1] == 'n' && word[2] == 't') ? T_INT : -1;
+        }
+        return (word[0] == 'd' && word[1] == 'e' && word[2] == 'f') ? T_DEF : -1;
+    case 4:
+        return memcmp(word, "else", 4) == 0 ? T_ELSE : -1;
+    case 5:
+        return memcmp(word, "print", 5) == 0 ? T_PRINT : -1;
+    case 6:
+        return memcmp(word, "return", 6) == 0 ? T_RETURN : -1;
+    default:
+        return -1;
+    }
+}
+
+// Retorna o terminal de um operador/delimitador de um caractere
+static int punct_type(char c)
+{
+    switch (c)
+    {
+    case '{': return T_LBRACE;
+    case '}': return T_RBRACE;
+    case '(': return T_LPAREN;
+    case ')': return T_RPAREN;
+    case ',': return T_COMMA;
+    case ';': return T_SEMICOLON;
+    case '<': return T_LT;
+    case '>': return T_GT;
+    case '=': return T_EQ;
+    case '+': return T_PLUS;
+    case '-': return T_MINUS;
+    case '*': return T_STAR;
+    case '/': return T_SLASH;
+    case '$': return T_END;
+    default: return T_INVALID;
+    }
+}
+
+static inline bool emit(TokenArray *out, size_t offset, size_t length, int type)
+{
+    if (out->count == out->capacity)
+    {
+        size_t capacity = out->capacity ? out->capacity * 2 : 256;
+        Token *tokens = counted_realloc(out->tokens, capacity * sizeof(Token));
+        if (tokens == NULL)
+        {
+            return false;
+        }
+        out->tokens = tokens;
+        out->capacity = capacity;
+    }
+    Token *tk = &out->tokens[out->count++];
+    tk->offset = (uint32_t)offset;
+    tk->length = (uint32_t)length;
+    tk->type = (uint8_t)type;
+    return true;
+}
+
+// Classificação dos caracteres em blocos de 64 bytes: um bit por byte em cada
+// máscara. Bytes depois do fim do fonte não pertencem a nenhuma classe.
+enum
+{
+    CLASS_SPACE, // ' ', '\t', '\n', '\v', '\f', '\r' (isspace no locale "C")
+    CLASS_WORD,  // letras e dígitos ASCII (isalnum)
+    CLASS_DIGIT, // dígitos ASCII (isdigit)
+    CLASS_COLON, // primeiros caracteres dos operadores de dois caracteres
+    CLASS_LT,
+    CLASS_GT,
+    CLASS_EQ,
+    NUM_CLASSES
+};
+
+#define BLOCK_SIZE 64
+
+typedef void (*ClassifyFn)(const unsigned char *p, uint64_t mask[NUM_CLASSES]);
+
+// O laço do lexer é instanciado uma vez por classificação, com ela embutida
+#define LEXER_INLINE static inline __attribute__((always_inline))
+
+LEXER_INLINE int is_space(unsigned char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+LEXER_INLINE int is_digit(unsigned char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+LEXER_INLINE int is_alpha(unsigned char c)
+{
+    return (unsigned char)((c | 0x20) - 'a') < 26;
+}
+
+// Classifica os n primeiros bytes de p (n <= 64), um de cada vez
+LEXER_INLINE void classify_scalar_n(const unsigned char *p, size_t n, uint64_t mask[NUM_CLASSES])
+{
+    memset(mask, 0, NUM_CLASSES * sizeof(uint64_t));
+    for (size_t k = 0; k < n; k++)
+    {
+        uint64_t bit = (uint64_t)1 << k;
+        unsigned char c = p[k];
+        mask[CLASS_SPACE] |= is_space(c) ? bit : 0;
+        mask[CLASS_DIGIT] |= is_digit(c) ? bit : 0;
+        mask[CLASS_WORD] |= (is_digit(c) || is_alpha(c)) ? bit : 0;
+        mask[CLASS_COLON] |= c == ':' ? bit : 0;
+        mask[CLASS_LT] |= c == '<' ? bit : 0;
+        mask[CLASS_GT] |= c == '>' ? bit : 0;
+        mask[CLASS_EQ] |= c == '=' ? bit : 0;
+    }
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define LEXER_HAVE_X86 1
+
+// 16 bytes por comparação. As comparações são com sinal, mas todos os limites
+// são ASCII, então bytes >= 0x80 (negativos) nunca entram em nenhuma classe.
+__attribute__((target("sse2"))) LEXER_INLINE void classify_sse2(const unsigned char *p, uint64_t mask[NUM_CLASSES])
+{
+    memset(mask, 0, NUM_CLASSES * sizeof(uint64_t));
+    for (int k = 0; k < BLOCK_SIZE / 16; k++)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i *)(p + 16 * k));
+        __m128i space = _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8(' ')),
+                                     _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('\t' - 1)),
+                                                   _mm_cmplt_epi8(c, _mm_set1_epi8('\r' + 1))));
+        __m128i digit = _mm_and_si128(_mm_cmpgt_epi8(c, _mm_set1_epi8('0' - 1)),
+                                      _mm_cmplt_epi8(c, _mm_set1_epi8('9' + 1)));
+        __m128i lower = _mm_or_si128(c, _mm_set1_epi8(0x20));
+        __m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, _mm_set1_epi8('a' - 1)),
+                                      _mm_cmplt_epi8(lower, _mm_set1_epi8('z' + 1)));
+        mask[CLASS_SPACE] |= (uint64_t)(uint16_t)_mm_movemask_epi8(space) << (16 * k);
+        mask[CLASS_DIGIT] |= (uint64_t)(uint16_t)_mm_movemask_epi8(digit) << (16 * k);
+        mask[CLASS_WORD] |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_or_si128(alpha, digit)) << (16 * k);
+        mask[CLASS_COLON] |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8(':'))) << (16 * k);
+        mask[CLASS_LT] |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('<'))) << (16 * k);
+        mask[CLASS_GT] |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('>'))) << (16 * k);
+        mask[CLASS_EQ] |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(c, _mm_set1_epi8('='))) << (16 * k);
+    }
+}
+
+// 32 bytes por comparação
+__attribute__((target("avx2"))) LEXER_INLINE void classify_avx2(const unsigned char *p, uint64_t mask[NUM_CLASSES])
+{
+    memset(mask, 0, NUM_CLASSES * sizeof(uint64_t));
+    for (int k = 0; k < BLOCK_SIZE / 32; k++)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i *)(p + 32 * k));
+        __m256i space = _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(' ')),
+                                        _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('\t' - 1)),
+                                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('\r' + 1), c)));
+        __m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(c, _mm256_set1_epi8('0' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('9' + 1), c));
+        __m256i lower = _mm256_or_si256(c, _mm256_set1_epi8(0x20));
+        __m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, _mm256_set1_epi8('a' - 1)),
+                                         _mm256_cmpgt_epi8(_mm256_set1_epi8('z' + 1), lower));
+        mask[CLASS_SPACE] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(space) << (32 * k);
+        mask[CLASS_DIGIT] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(digit) << (32 * k);
+        mask[CLASS_WORD] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_or_si256(alpha, digit)) << (32 * k);
+        mask[CLASS_COLON] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8(':'))) << (32 * k);
+        mask[CLASS_LT] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('<'))) << (32 * k);
+        mask[CLASS_GT] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('>'))) << (32 * k);
+        mask[CLASS_EQ] |= (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('='))) << (32 * k);
+    }
+}
+#endif
+
+// Melhor implementação suportada pela CPU em que o programa está rodando
+LexerImpl lexer_best_impl(void)
+{
+#ifdef LEXER_HAVE_X86
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return LEXER_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return LEXER_SSE2;
+    }
+#endif
+    return LEXER_SCALAR;
+}
+
+const char *lexer_impl_name(LexerImpl impl)
+{
+    switch (impl)
+    {
+    case LEXER_SCALAR: return "escalar";
+    case LEXER_SSE2: return "SSE2";
+    case LEXER_AVX2: return "AVX2";
+    default: return "automatico";
+    }
+}
+
+// Emite o lexema src[start, start + length); o tipo sai do primeiro caractere
+// (e do tamanho, para palavras reservadas e operadores de dois caracteres)
+LEXER_INLINE bool emit_lexeme(TokenArray *out, const char *src, size_t start, size_t length)
+{
+    unsigned char c = (unsigned char)src[start];
+    int type;
+    if (is_digit(c))
+    {
+        type = T_NUM;
+    }
+    else if (is_alpha(c))
+    {
+        type = length <= 6 ? reserved_word_type(&src[start], length) : -1;
+        if (type == -1)
+        {
+            type = T_ID;
+        }
+    }
+    else if (length == 2)
+    {
+        type = c == ':' ? T_ASSIGN : c == '>' ? T_GE : c == '=' ? T_EQEQ : src[start + 1] == '=' ? T_LE : T_NE;
+    }
+    else
+    {
+        type = punct_type((char)c);
+    }
+    return emit(out, start, length, type);
+}
+
+// Laço do lexer. Para cada bloco calcula, só com operações de bits, a máscara
+// dos inícios de lexema (T) e a dos inícios de sequências de espaços; cada
+// lexema vai do seu início até o próximo bit de qualquer uma das duas. Os
+// estados carry_* levam o último bit de cada máscara para o bloco seguinte.
+LEXER_INLINE int tokenize_blocks(const char *src, size_t len, TokenArray *out, ClassifyFn classify)
+{
+    const unsigned char *u = (const unsigned char *)src;
+    uint64_t carry_space = 0, carry_word = 0, carry_number = 0, carry_op = 0, carry_lt = 0, carry_second = 0;
+    size_t start = 0;
+    int pending = 0; // há um lexema começado em start ainda sem fim
+
+    for (size_t base = 0; base < len; base += BLOCK_SIZE)
+    {
+        uint64_t m[NUM_CLASSES];
+        uint64_t valid = ~(uint64_t)0;
+        if (base + BLOCK_SIZE <= len)
+        {
+            classify(u + base, m);
+        }
+        else
+        {
+            classify_scalar_n(u + base, len - base, m);
+            valid = ((uint64_t)1 << (len - base)) - 1;
+        }
+        uint64_t space = m[CLASS_SPACE], word = m[CLASS_WORD], digit = m[CLASS_DIGIT];
+
+        // Palavras começam onde a sequência de letras e dígitos começa; números
+        // são os dígitos iniciais dessas sequências (a soma propaga o início
+        // por dígitos consecutivos), e uma letra logo depois de um número
+        // começa um identificador
+        uint64_t word_start = word & ~((word << 1) | carry_word);
+        uint64_t number_start = digit & (word_start | carry_number);
+        uint64_t number = digit & ~(digit + number_start);
+        uint64_t ident_after_number = word & ~digit & ((number << 1) | carry_number);
+
+        // Segundo caractere de ':=', '<=', '>=', '==' e '<>'
+        uint64_t op = m[CLASS_COLON] | m[CLASS_LT] | m[CLASS_GT] | m[CLASS_EQ];
+        uint64_t second = (m[CLASS_EQ] & ((op << 1) | carry_op)) | (m[CLASS_GT] & ((m[CLASS_LT] << 1) | carry_lt));
+        if (second & ((second << 1) | carry_second))
+        {
+            // Sequências como "===" ou "<>=": só é segundo caractere quem vem
+            // depois de um início de lexema, então decide da esquerda para a direita
+            uint64_t resolved = 0, candidates = second;
+            while (candidates)
+            {
+                int k = __builtin_ctzll(candidates);
+                candidates &= candidates - 1;
+                uint64_t before = k ? (resolved >> (k - 1)) & 1 : carry_second;
+                if (!before)
+                {
+                    resolved |= (uint64_t)1 << k;
+                }
+            }
+            second = resolved;
+        }
+
+        uint64_t other = valid & ~space & ~word & ~second;
+        uint64_t starts = word_start | ident_after_number | other;
+        uint64_t bounds = starts | (space & ~((space << 1) | carry_space));
+
+        carry_space = space >> 63;
+        carry_word = word >> 63;
+        carry_number = number >> 63;
+        carry_op = op >> 63;
+        carry_lt = m[CLASS_LT] >> 63;
+        carry_second = second >> 63;
+
+        // Lexema que atravessou o fim do bloco anterior
+        if (pending && bounds)
+        {
+            if (!emit_lexeme(out, src, start, base + (size_t)__builtin_ctzll(bounds) - start))
+            {
+                return -1;
+            }
+            pending = 0;
+        }
+
+        while (starts)
+        {
+            int k = __builtin_ctzll(starts);
+            starts &= starts - 1;
+            uint64_t after = k == 63 ? 0 : bounds & (~(uint64_t)0 << (k + 1));
+            if (after == 0)
+            {
+                // Termina em outro bloco
+                pending = 1;
+                start = base + (size_t)k;
+            }
+            else if (!emit_lexeme(out, src, base + (size_t)k, (size_t)(__builtin_ctzll(after) - k)))
+            {
+                return -1;
+            }
+        }
+    }
+
+    if (pending && !emit_lexeme(out, src, start, len - start))
+    {
+        return -1;
+    }
+    return 0;
+}
+
+// Implementação escalar: um byte de cada vez, atravessando cada sequência de
+// espaços, letras ou dígitos em um laço curto
+static int tokenize_scalar(const char *src, size_t len, TokenArray *out)
+{
+    const unsigned char *u = (const unsigned char *)src;
+    size_t i = 0;
+    while (i < len)
+    {
+        unsigned char ch = u[i];
+        size_t start = i;
+        if (is_space(ch))
+        {
+            i++;
+            continue;
+        }
+        else if (is_alpha(ch))
+        {
+            while (i < len && (is_alpha(u[i]) || is_digit(u[i])))
+            {
+                i++;
+            }
+        }
+        else if (is_digit(ch))
+        {
+            while (i < len && is_digit(u[i]))
+            {
+                i++;
+            }
+        }
+        else
+        {
+            char next = (i + 1 < len) ? src[i + 1] : '\0';
+            int pair = (next == '=' && (ch == ':' || ch == '<' || ch == '>' || ch == '=')) || (ch == '<' && next == '>');
+            i += pair ? 2 : 1;
+        }
+
+        if (!emit_lexeme(out, src, start, i - start))
+        {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+#ifdef LEXER_HAVE_X86
+__attribute__((target("sse2"))) static int tokenize_sse2(const char *src, size_t len, TokenArray *out)
+{
+    return tokenize_blocks(src, len, out, classify_sse2);
+}
+
+__attribute__((target("avx2"))) static int tokenize_avx2(const char *src, size_t len, TokenArray *out)
+{
+    return tokenize_blocks(src, len, out, classify_avx2);
+}
+#endif
+
+// Converte o fonte em uma sequência de terminais, guardando a posição de cada
+// lexema. Com SSE2 ou AVX2 os caracteres são classificados 64 de cada vez; usa
+// a implementação pedida ou, se a CPU não a suportar (ou com LEXER_AUTO), a
+// melhor disponível.
+// Retorna 0 em caso de sucesso e -1 se faltar memória.
+int tokenize_input_impl(const char *src, size_t len, TokenArray *out, LexerImpl impl)
+{
+    out->count = 0;
+    if (len == 0)
+    {
+        return 0;
+    }
+
+    LexerImpl best = lexer_best_impl();
+    if (impl == LEXER_AUTO || impl > best)
+    {
+        impl = best;
+    }
+#ifdef LEXER_HAVE_X86
+    if (impl == LEXER_AVX2)
+    {
+        return tokenize_avx2(src, len, out);
+    }
+    if (impl == LEXER_SSE2)
+    {
+        return tokenize_sse2(src, len, out);
+    }
+#endif
+    return tokenize_scalar(src, len, out);
+}
+
+// Trecho do fonte analisado por uma thread do lexer paralelo
+typedef struct
+{
+    const char *src;
+    size_t begin;
+    size_t end;
+    TokenArray tokens;
+    int status;
+} LexerSlice;
+
+static void *lex_slice(void *arg)
+{
+    LexerSlice *s = arg;
+    s->status = tokenize_input_impl(s->src + s->begin, s->end - s->begin, &s->tokens, LEXER_AUTO);
+    for (size_t i = 0; i < s->tokens.count; i++)
+    {
+        s->tokens.tokens[i].offset += (uint32_t)s->begin;
+    }
+    return NULL;
+}
+
+// Lexer paralelo: divide o fonte em até threads trechos e desloca o início de
+// cada um até um espaço. Nenhum lexema contém espaços e todo lexema termina
+// antes de um, então cada trecho começa fora de qualquer lexema e o lexer
+// serial chega ao mesmo estado ali; os vetores de cada thread, concatenados,
+// são exatamente os tokens do lexer serial. Trechos sem espaço se juntam ao
+// seguinte. Retorna 0 em caso de sucesso e -1 se faltar memória.
+int tokenize_input_parallel(const char *src, size_t len, TokenArray *out, int threads)
+{
+    if (threads > LEXER_MAX_THREADS)
+    {
+        threads = LEXER_MAX_THREADS;
+    }
+    if (threads <= 1 || len == 0)
+    {
+        return tokenize_input_impl(src, len, out, LEXER_AUTO);
+    }
+
+    LexerSlice slices[LEXER_MAX_THREADS];
+    pthread_t ids[LEXER_MAX_THREADS];
+    int started[LEXER_MAX_THREADS] = {0};
+    size_t begin = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        size_t end = (i == threads - 1) ? len : (size_t)((uint64_t)len * (uint64_t)(i + 1) / (uint64_t)threads);
+        if (end < begin)
+        {
+            end = begin;
+        }
+        while (end < len && !is_space((unsigned char)src[end]))
+        {
+            end++;
+        }
+        slices[i] = (LexerSlice){src, begin, end, {NULL, 0, 0}, 0};
+        begin = end;
+    }
+
+    // A thread que chamou analisa o primeiro trecho; se não der para criar
+    // uma thread, o trecho dela também é analisado aqui
+    for (int i = 1; i < threads; i++)
+    {
+        started[i] = pthread_create(&ids[i], NULL, lex_slice, &slices[i]) == 0;
+    }
+    lex_slice(&slices[0]);
+    size_t total = 0;
+    int status = 0;
+    for (int i = 0; i < threads; i++)
+    {
+        if (i > 0 && started[i])
+        {
+            pthread_join(ids[i], NULL);
+        }
+        else if (i > 0)
+        {
+            lex_slice(&slices[i]);
+        }
+        status |= slices[i].status;
+        total += slices[i].tokens.count;
+    }
+
+    out->count = 0;
+    if (status == 0 && total > out->capacity)
+    {
+        Token *tokens = counted_realloc(out->tokens, total * sizeof(Token));
+        if (tokens == NULL)
+        {
+            status = -1;
+        }
+        else
+        {
+            out->tokens = tokens;
+            out->capacity = total;
+        }
+    }
+    for (int i = 0; i < threads; i++)
+    {
+        if (status == 0 && slices[i].tokens.count > 0)
+        {
+            memcpy(out->tokens + out->count, slices[i].tokens.tokens, slices[i].tokens.count * sizeof(Token));
+            out->count += slices[i].tokens.count;
+        }
+        token_array_free(&slices[i].tokens);
+    }
+    return status;
+}
+
+// Entradas grandes usam o lexer paralelo, com uma thread por núcleo e pelo
+// menos LEXER_PARALLEL_MIN / 4 bytes por thread
+int tokenize_input(const char *src, size_t len, TokenArray *out)
+{
+    if (len >= LEXER_PARALLEL_MIN)
+    {
+        long threads = sysconf(_SC_NPROCESSORS_ONLN);
+        long most = (long)(len / (LEXER_PARALLEL_MIN / 4));
+        if (threads > most)
+        {
+            threads = most;
+        }
+        if (threads > 1)
+        {
+            return tokenize_input_parallel(src, len, out, (int)threads);
+        }
+    }
+    return tokenize_input_impl(src, len, out, LEXER_AUTO);
+}
+
+void token_array_free(TokenArray *arr)
+{
+    free(arr->tokens);
+    arr->tokens = NULL;
+    arr->count = 0;
+    arr->capacity = 0;
+}
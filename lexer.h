@@ -0,0 +1,47 @@
+#ifndef LEXER_H
+#define LEXER_H
+
+#include "parser.h"
+#include <stdint.h>
+
+// Token: índice do terminal em terminals[] + posição do lexema no fonte original
+// (offsets de 32 bits: parser_parse_buffer recusa entradas acima de 4 GiB)
+typedef struct Token
+{
+    uint32_t offset;
+    uint32_t length;
+    uint8_t type;
+} Token;
+
+// Sequência de tokens produzida pelo lexer
+typedef struct TokenArray
+{
+    Token *tokens;
+    size_t count;
+    size_t capacity;
+} TokenArray;
+
+// Classificação de caracteres usada pelo lexer; LEXER_AUTO escolhe a melhor
+// suportada pela CPU em tempo de execução
+typedef enum
+{
+    LEXER_AUTO,
+    LEXER_SCALAR,
+    LEXER_SSE2,
+    LEXER_AVX2
+} LexerImpl;
+
+int reserved_word_type(const char *word, size_t len);
+int tokenize_input(const char *src, size_t len, TokenArray *out);
+int tokenize_input_impl(const char *src, size_t len, TokenArray *out, LexerImpl impl);
+
+// A partir deste tamanho, tokenize_input divide o fonte entre os núcleos
+// (tokenize_input_parallel); o resultado é o mesmo do lexer serial
+#define LEXER_PARALLEL_MIN (4u << 20)
+#define LEXER_MAX_THREADS 64
+int tokenize_input_parallel(const char *src, size_t len, TokenArray *out, int threads);
+LexerImpl lexer_best_impl(void);
+const char *lexer_impl_name(LexerImpl impl);
+void token_array_free(TokenArray *arr);
+
+#endif
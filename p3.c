@@ -1,361 +1,296 @@
 #include "parser.h"
-#include <ctype.h>
-#include <stdbool.h>
+#include "source.h"
+#include "batch.h"
+#include "split.h"
+#include "server.h"
+#include "stream.h"
+#include "semantic.h"
+#include "tables.h"
+#include <stdlib.h>
 #include <string.h>
 
-// Pilha para o parsing
-char *stack[MAX_STACK];
-int top = -1;
-
-void log_pilha() {
-    printf("PILHA ATUAL: ");
-    for (int i = top; i >= 0; i--) {
-        printf("%s ", stack[i]);
-    }
-    printf("\n");
-}
-
-//Adiciona um símbolo ao topo da pilha.
-void push(const char *symbol) {
-    if (top < MAX_STACK - 1) {
-        stack[++top] = strdup(symbol);
-        if (stack[top] == NULL) {
-            printf("Erro: Falha ao alocar memória!\n");
-            exit(1);
+// Imprime a entrada como uma única linha, como se as linhas não vazias
+// fossem concatenadas com espaços (sem copiar o arquivo)
+static void print_joined(const char *src, size_t len)
+{
+    size_t i = 0;
+    int first = 1;
+    while (i < len)
+    {
+        const char *nl = memchr(src + i, '\n', len - i);
+        size_t end = nl ? (size_t)(nl - src) : len;
+        size_t line_end = end;
+        if (line_end > i && src[line_end - 1] == '\r')
+        {
+            line_end--;
+        }
+        if (line_end > i)
+        {
+            if (!first)
+            {
+                putchar(' ');
+            }
+            fwrite(src + i, 1, line_end - i, stdout);
+            first = 0;
         }
-    } else {
-        printf("Erro: Pilha cheia!\n");
-        exit(1);
+        i = end + 1;
     }
 }
 
-//Remove e retorna o símbolo do topo da pilha.
-const char *pop() {
-    if (top >= 0) {
-        char *popped = stack[top--];
-        return popped;
-    } else {
-        printf("Erro: Pilha vazia!\n");
-        exit(1);
-    }
-}
+// Trecho mostrado de cada lado da coluna em linhas longas (programas gerados)
+#define LOCATION_CONTEXT 60
 
-//Retorna o símbolo no topo da pilha sem removê-lo.
-const char *peek()
+// Mostra a linha do fonte que contém offset e marca a coluna com '^'
+static void print_location(SourceMap *lines, const char *src, size_t len, size_t offset)
 {
-    if (top >= 0)
+    SourcePosition pos;
+    if (source_map_locate(lines, offset, &pos) != 0)
     {
-        return stack[top];
+        return;
     }
-    else
+    const char *nl = memchr(src + offset, '\n', len - offset);
+    size_t end = nl ? (size_t)(nl - src) : len;
+    if (end > offset && src[end - 1] == '\r')
     {
-        return NULL;
+        end--;
     }
-}
-
-void parse(const char *inputLine) {
-    char buffer[MAX_INPUT];
-    strcpy(buffer, inputLine);
-
-    char *inputTokens[300];
-    int inputCount = 0;
-    char *tk = strtok(buffer, " ");
-    while (tk != NULL) {
-        inputTokens[inputCount++] = tk;
-        tk = strtok(NULL, " ");
-    }
-
-    int inputIndex = 0;
-    push("$");
-    push("S");
-
-    printf("Iniciando parsing...\n\n");
-
-    while (1) {
-        const char *top_symbol = peek();
-        const char *current_input = (inputIndex < inputCount) ? inputTokens[inputIndex] : NULL;
-
-        if (top_symbol == NULL) {
-            printf("Erro: Pilha vazia antes do fim da entrada!\n");
-            return;
+    size_t from = pos.line_start, to = end;
+    if (offset - from > LOCATION_CONTEXT)
+    {
+        from = offset - LOCATION_CONTEXT;
+        while (((unsigned char)src[from] & 0xC0) == 0x80)
+        {
+            from++;
         }
-
-        if (strcmp(top_symbol, "$") == 0) {
-            if (current_input != NULL && strcmp(current_input, "$") == 0) {
-                pop();
-                printf("Entrada aceita!\n");
-            } else {
-                printf("Erro: Entrada não terminou em $!\n");
-            }
-            return;
+    }
+    if (to > offset && to - offset > LOCATION_CONTEXT)
+    {
+        to = offset + LOCATION_CONTEXT;
+        while (to < end && ((unsigned char)src[to] & 0xC0) == 0x80)
+        {
+            to++;
         }
+    }
 
-        int terIndex = getTerminalIndex(top_symbol);
-        if (terIndex != -1) {
-            // Símbolo do topo é terminal
-            if (current_input != NULL && strcmp(top_symbol, current_input) == 0) {
-                printf("Match: %s\n", top_symbol);
-                pop();
-                log_pilha();
-                inputIndex++;
-            } else {
-                printf("Erro sintático: Esperava '%s', obteve '%s'\n", top_symbol, current_input ? current_input : "EOF");
-                return;
-            }
-        } else {
-            // Símbolo do topo é não-terminal
-            int row = getNonTerminalIndex(top_symbol);
-            int col = (current_input != NULL) ? getTerminalIndex(current_input) : -1;
-
-            if (row == -1 || col == -1 || table[row][col] == NULL) {
-                printf("Erro sintático: Não há produção para <%s> com lookahead '%s'\n", top_symbol, current_input ? current_input : "EOF");
-                return;
-            }
-
-            const char *production = table[row][col];
-            printf("Produção usada: %s -> %s\n", top_symbol, (strlen(production) > 0) ? production : "ε");
-            //printf("DEBUG: Token atual '%s' determinou a produção: %s -> %s\n",
-            //current_input ? current_input : "EOF", top_symbol, 
-            //production && strlen(production) > 0 ? production : "ε");
-            pop();
-
-            if (strlen(production) > 0) {
-                // Limpa espaços no final da produção
-                char temp[MAX_INPUT];
-                strcpy(temp, production);
-                int end = (int)strlen(temp) - 1;
-                while (end >= 0 && isspace((unsigned char)temp[end])) {
-                    temp[end--] = '\0';
-                }
-
-                char tokens[50][MAX_INPUT];
-                int count = tokenize_production(temp, tokens, 50);
-                if (count == -1) {
-                    printf("Erro ao tokenizar produção!\n");
-                    return;
-                }
-
-                // Depuração: Imprime os tokens obtidos
-                for (int i = 0; i < count; i++) {
-                    // Verifica se o token é válido (opcional)
-                    if (getNonTerminalIndex(tokens[i]) == -1 && getTerminalIndex(tokens[i]) == -1) {
-                        printf("Erro: Token inválido '%s' encontrado na produção\n", tokens[i]);
-                        return;
-                    }
-                }
-
-                for (int i = count - 1; i >= 0; i--) {
-                    if (strcmp(tokens[i], "ε") != 0) {
-                        push(tokens[i]);
-                    }
-                }
-                log_pilha();
-            } else {
-                // Produção vazia (ε)
-                continue;
-            }
-        }
-        printf("INPUT: ");
-        for (int i = inputIndex; i < inputCount; i++) {
-            printf("%s%s", inputTokens[i], (i < inputCount - 1) ? " " : "");
+    printf("Linha %u, coluna %u:\n    %s", pos.line, pos.column, from > pos.line_start ? "..." : "");
+    fwrite(src + from, 1, to - from, stdout);
+    printf("%s\n    %s", to < end ? "..." : "", from > pos.line_start ? "   " : "");
+    for (size_t i = from; i < offset; i++)
+    {
+        if (((unsigned char)src[i] & 0xC0) != 0x80)
+        {
+            putchar(src[i] == '\t' ? '\t' : ' ');
         }
-        printf("\n");
     }
+    printf("^\n");
 }
 
-// Verifica se uma string é uma palavra reservada
-bool is_reserved_word(const char *word)
+// Imprime os erros semânticos em ordem do fonte, com linha e coluna; retorna
+// quantos foram encontrados ou -1 se faltar memória
+static int check_semantics(const char *src, const TokenArray *tokens, SourceMap *lines)
 {
-    const char *reserved[] = {"int", "if", "else", "def", "print", "return"};
-    int num_reserved = sizeof(reserved) / sizeof(reserved[0]);
-    for (int i = 0; i < num_reserved; i++)
+    SemanticResult result;
+    int errors = semantic_check(src, tokens, &result);
+    if (errors < 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+    }
+    for (int i = 0; i < errors; i++)
     {
-        if (strcmp(word, reserved[i]) == 0)
+        char message[256];
+        semantic_message(&result, &result.diagnostics[i], message, sizeof(message));
+        SourcePosition pos;
+        if (source_map_locate(lines, result.diagnostics[i].offset, &pos) == 0)
+        {
+            printf("%s (linha %u, coluna %u)\n", message, pos.line, pos.column);
+        }
+        else
         {
-            return true;
+            printf("%s\n", message);
         }
     }
-    return false;
+    if (errors > 0)
+    {
+        printf("%d erro(s) semântico(s).\n", errors);
+    }
+    semantic_free(&result);
+    return errors;
 }
 
-// Substitui identificadores por 'id', números por 'num', e separa os tokens
-void tokenize_input(char *input)
+int main(int argc, char *argv[])
 {
-    char buffer[MAX_INPUT];
-    int j = 0;
-
-    for (int i = 0; input[i] != '\0'; i++)
+    if (argc > 1 && strcmp(argv[1], "--batch") == 0)
     {
-        if (isalpha(input[i]))
-        { // Detecta identificadores ou palavras reservadas
-            char temp[50];
-            int k = 0;
-
-            // Captura a palavra completa
-            while (isalnum(input[i]) && k < 49)
-            {
-                temp[k++] = input[i++];
-            }
-            temp[k] = '\0'; // Finaliza a string temporária
-            i--;            // Reposiciona o índice
+        return run_batch(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--split") == 0)
+    {
+        return run_split(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--serve") == 0)
+    {
+        return run_server(argc - 2, argv + 2);
+    }
+    if (argc > 1 && strcmp(argv[1], "--stream") == 0)
+    {
+        return run_stream(argc - 2, argv + 2);
+    }
 
-            if (is_reserved_word(temp))
-            {
-                // É uma palavra reservada
-                if (j > 0 && !isspace(buffer[j - 1]))
-                {
-                    buffer[j++] = ' ';
-                }
-                strcpy(&buffer[j], temp);
-                j += strlen(temp);
-                buffer[j++] = ' ';
-            }
-            else
-            {
-                // É um identificador genérico
-                if (j > 0 && !isspace(buffer[j - 1]))
-                {
-                    buffer[j++] = ' ';
-                }
-                buffer[j++] = 'i';
-                buffer[j++] = 'd';
-                buffer[j++] = ' ';
-            }
+    // Opções: -q (só o veredito) ou -v N (0 = só o veredito, 1 = produções,
+    // 2 = produções e matches, 3 = trace completo, o padrão); -s acrescenta a
+    // análise semântica quando a entrada é sintaticamente válida; -t imprime a
+    // árvore sintática de uma entrada aceita; -r continua depois de cada erro
+    // sintático e relata todos; -m grava os contadores do parser em JSON; -g
+    // troca a gramática embutida por um dialeto (BNF ou tabelas compiladas)
+    const char *path = NULL;
+    int verbosity = TRACE_FULL;
+    int semantic = 0;
+    int print_tree = 0;
+    int recovery = 0;
+    const char *stats_path = NULL;
+    const char *grammar_path = NULL;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+        {
+            verbosity = TRACE_QUIET;
         }
-        else if (isdigit(input[i]))
-        { // Detecta números
-            if (j > 0 && !isspace(buffer[j - 1]))
-            {
-                buffer[j++] = ' ';
-            }
-            while (isdigit(input[i]))
-            { // Consome todo o número
-                i++;
-            }
-            buffer[j++] = 'n';
-            buffer[j++] = 'u';
-            buffer[j++] = 'm';
-            buffer[j++] = ' ';
-            i--; // Reposiciona o índice
+        else if (strcmp(argv[i], "-s") == 0)
+        {
+            semantic = 1;
         }
-        else if (ispunct(input[i]))
-        { // Detecta operadores ou delimitadores
-            if (j > 0 && !isspace(buffer[j - 1]))
-            {
-                buffer[j++] = ' ';
-            }
-
-            // Trata ':=' como token único
-            if (input[i] == ':' && input[i + 1] == '=')
-            {
-                buffer[j++] = ':';
-                buffer[j++] = '=';
-                i++;
-            }
-            // Trata operadores relacionais
-            else if ((input[i] == '<' || input[i] == '>') && input[i + 1] == '=')
-            {
-                buffer[j++] = input[i];
-                buffer[j++] = '=';
-                i++;
-            }
-            else if ((input[i] == '<' && input[i + 1] == '>'))
-            { // <>
-                buffer[j++] = '<';
-                buffer[j++] = '>';
-                i++;
-            }
-            else
+        else if (strcmp(argv[i], "-t") == 0)
+        {
+            print_tree = 1;
+        }
+        else if (strcmp(argv[i], "-r") == 0)
+        {
+            recovery = 1;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            stats_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-g") == 0 && i + 1 < argc)
+        {
+            grammar_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+        {
+            // Só 0 a 3; qualquer outro valor mostra o uso
+            char *end;
+            long level = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || level < TRACE_QUIET || level > TRACE_FULL)
             {
-                buffer[j++] = input[i];
+                path = NULL;
+                break;
             }
-
-            buffer[j++] = ' ';
+            verbosity = (int)level;
         }
-        else if (!isspace(input[i]))
-        { // Outros caracteres não-espaço
-            buffer[j++] = input[i];
+        else if (path == NULL && argv[i][0] != '-')
+        {
+            path = argv[i];
+        }
+        else
+        {
+            path = NULL;
+            break;
         }
     }
-
-    // Remove espaços extras
-    int final_len = strlen(buffer);
-    while (final_len > 0 && isspace((unsigned char)buffer[final_len - 1]))
+    if (path == NULL)
     {
-        buffer[--final_len] = '\0';
+        printf("Uso: %s [-q | -v nivel] [-r] [-s] [-t] [-m metricas.json] [-g gramatica] <caminho_para_arquivo>\n", argv[0]);
+        printf("     %s --batch [-j threads] [-c cache] [-m metricas.json] [arquivos ou diretórios...]\n", argv[0]);
+        printf("     %s --split [-j threads] <caminho_para_arquivo>\n", argv[0]);
+        printf("     %s --serve [-j threads] [-u caminho_do_socket]\n", argv[0]);
+        printf("     %s --stream [-q | -v nivel] [-b bytes] [-m metricas.json] [arquivo | -]\n", argv[0]);
+        printf("O arquivo é limitado a 4 GiB (offsets de 32 bits); --stream não tem limite.\n");
+        return 1;
     }
 
-    strcpy(input, buffer);
-}
-
-int main(int argc, char *argv[])
-{
-    if (argc != 2)
+    // Com uma gramática compilada e atualizada, carregar é só mapear o arquivo
+    LoadedTables *tables = NULL;
+    if (grammar_path != NULL && (tables = tables_load(grammar_path, stderr)) == NULL)
     {
-        printf("Uso: %s <caminho_para_arquivo>\n", argv[0]);
         return 1;
     }
 
-    FILE *file = fopen(argv[1], "r");
-    if (!file)
+    SourceFile source;
+    if (source_open(&source, path) != 0)
     {
         perror("Erro ao abrir o arquivo");
+        tables_free(tables);
         return 1;
     }
+    const char *input = source.data;
 
-    char input[MAX_INPUT] = ""; // String onde será montada a entrada completa
-    char line[MAX_INPUT];       // Para ler cada linha individualmente
-    size_t current_length = 0;
-
-    while (fgets(line, sizeof(line), file) != NULL)
+    // Verifica se a entrada (sem os espaços finais) termina com '$'
+    size_t len;
+    if (!source_ends_with_marker(&source, &len))
     {
-        // Remove quebra de linha
-        line[strcspn(line, "\n")] = '\0'; // Remove '\n'
-        line[strcspn(line, "\r")] = '\0'; // Remove '\r'
-
-        // Ignorar linhas vazias
-        if (strlen(line) == 0)
-        {
-            continue;
-        }
-
-        // Checar se o novo conteúdo cabe no buffer
-        size_t line_length = strlen(line);
-        if (current_length + line_length + 1 >= MAX_INPUT)
-        {
-            printf("Erro: O arquivo de entrada é muito grande. Aumente MAX_INPUT.\n");
-            fclose(file);
-            return 1;
-        }
-
-        // Concatenar a linha no buffer de entrada
-        strcat(input, line);
-        strcat(input, " "); // Adiciona espaço para separar as linhas (se necessário)
-        current_length += line_length + 1;
+        printf("Erro: A entrada deve terminar com '$'. Última parte encontrada: '");
+        print_joined(input, len);
+        printf("'\n");
+        source_close(&source);
+        tables_free(tables);
+        return 1;
     }
 
-    fclose(file);
-
-    // Remove espaços extras no final da string concatenada
-    size_t len = strlen(input);
-    while (len > 0 && isspace((unsigned char)input[len - 1]))
+    if (verbosity >= TRACE_FULL)
     {
-        input[--len] = '\0';
+        printf("Entrada completa: ");
+        print_joined(input, len);
+        printf("\n");
     }
 
-    // Verifica se a entrada termina com '$'
-    if (len == 0 || input[len - 1] != '$')
+    Parser *parser = parser_create();
+    if (parser == NULL)
     {
-        printf("Erro: A entrada deve terminar com '$'. Última parte encontrada: '%s'\n", input);
+        printf("Erro: Falha ao alocar memória!\n");
+        source_close(&source);
+        tables_free(tables);
         return 1;
     }
+    if (tables != NULL)
+    {
+        parser_set_tables(parser, tables_get(tables));
+    }
+    parser_set_verbosity(parser, verbosity);
+    parser_set_build_tree(parser, print_tree);
+    parser_set_recovery(parser, recovery);
+    ParseStatus status = parser_parse_buffer(parser, input, len);
+
+    // As linhas do fonte só são indexadas se houver um diagnóstico
+    SourceMap lines = {0};
+    source_map_reset(&lines, input);
+    const ParseResult *result = parser_result(parser);
+    if (status == PARSE_SYNTAX_ERROR && !recovery && result->has_token)
+    {
+        print_location(&lines, input, len, result->offset);
+    }
+    if (print_tree && status == PARSE_ACCEPTED &&
+        parse_tree_print(parser_tree(parser), input, parser_tokens(parser), stdout) != 0)
+    {
+        status = PARSE_OUT_OF_MEMORY;
+        printf("Erro: Falha ao alocar memória!\n");
+    }
+    int errors = 0;
+    if (semantic && status == PARSE_ACCEPTED)
+    {
+        errors = check_semantics(input, parser_tokens(parser), &lines);
+    }
+    if (stats_path != NULL && parser_stats_save(parser_stats(parser), stats_path) != 0)
+    {
+        perror("Erro ao gravar as métricas");
+    }
+    source_map_free(&lines);
+    parser_destroy(parser);
+    tables_free(tables);
+    source_close(&source);
 
-    printf("Entrada completa: %s\n", input);
-
-    initialize_table();
-
-    tokenize_input(input);
-    parse(input);
-
-    return 0;
+    if (status == PARSE_OUT_OF_MEMORY || status == PARSE_INPUT_TOO_LARGE || errors < 0)
+    {
+        return 1;
+    }
+    return (status == PARSE_ACCEPTED && errors == 0) ? 0 : 2;
 }
\ No newline at end of file
@@ -0,0 +1,317 @@
+// Cliente de teste do modo servidor (p3 --serve -u caminho): envia os
+// arquivos dados, em rodízio, por várias conexões simultâneas, cada uma com
+// até -p requisições em voo (pipeline), e mede a latência de cada
+// requisição, do início do envio até a chegada da resposta.
+//
+// Uso: ./p3_client -u caminho_do_socket [-c conexoes] [-p pipeline] [-n requisicoes] arquivos...
+#include "server.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+// Requisição pronta para envio: tamanho seguido do conteúdo do arquivo
+typedef struct
+{
+    unsigned char *data;
+    size_t len;
+    const char *path;
+} Frame;
+
+typedef struct
+{
+    const char *socket_path;
+    const Frame *frames;
+    int num_frames;
+    int pipeline;
+    long requests;
+    double *latencies; // uma por requisição
+    long counts[8];    // respostas por status (0..5; 6 = inválida)
+    long mismatches;   // status diferente do da primeira resposta ao mesmo arquivo
+    int *first_status;
+    int failed;
+} Connection;
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int load_frame(Frame *f, const char *path)
+{
+    FILE *fp = fopen(path, "rb");
+    if (fp == NULL)
+    {
+        return -1;
+    }
+    struct stat st;
+    if (fstat(fileno(fp), &st) != 0 || (uint64_t)st.st_size > SERVER_MAX_REQUEST)
+    {
+        fclose(fp);
+        return -1;
+    }
+    f->len = 4 + (size_t)st.st_size;
+    f->data = malloc(f->len);
+    f->path = path;
+    if (f->data == NULL || fread(f->data + 4, 1, f->len - 4, fp) != f->len - 4)
+    {
+        fclose(fp);
+        return -1;
+    }
+    server_put32(f->data, (uint32_t)(f->len - 4));
+    fclose(fp);
+    return 0;
+}
+
+static int connect_to(const char *path)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    return fd;
+}
+
+// Uma conexão: escreve enquanto houver espaço no pipeline e lê as respostas
+// assim que chegam (poll), para que nenhum dos lados bloqueie o outro
+static void *run_connection(void *arg)
+{
+    Connection *c = arg;
+    int fd = connect_to(c->socket_path);
+    double *sent_at = malloc((size_t)c->pipeline * sizeof(double));
+    size_t capacity = 65536, have = 0;
+    unsigned char *input = malloc(capacity);
+    if (fd < 0 || sent_at == NULL || input == NULL)
+    {
+        c->failed = 1;
+        free(sent_at);
+        free(input);
+        return NULL;
+    }
+
+    long sent = 0, received = 0;
+    size_t written = 0; // bytes já enviados da requisição atual
+    while (received < c->requests)
+    {
+        struct pollfd p = {fd, POLLIN, 0};
+        if (sent < c->requests && sent - received < c->pipeline)
+        {
+            p.events |= POLLOUT;
+        }
+        if (poll(&p, 1, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            c->failed = 1;
+            break;
+        }
+        if (p.revents & POLLOUT)
+        {
+            const Frame *f = &c->frames[sent % c->num_frames];
+            if (written == 0)
+            {
+                sent_at[sent % c->pipeline] = now_seconds();
+            }
+            ssize_t n = write(fd, f->data + written, f->len - written);
+            if (n > 0 && (written += (size_t)n) == f->len)
+            {
+                written = 0;
+                sent++;
+            }
+            else if (n < 0 && errno != EAGAIN && errno != EINTR)
+            {
+                c->failed = 1;
+                break;
+            }
+        }
+        if (p.revents & (POLLIN | POLLHUP | POLLERR))
+        {
+            if (have == capacity)
+            {
+                capacity *= 2;
+                unsigned char *bigger = realloc(input, capacity);
+                if (bigger == NULL)
+                {
+                    c->failed = 1;
+                    break;
+                }
+                input = bigger;
+            }
+            ssize_t n = read(fd, input + have, capacity - have);
+            if (n == 0 || (n < 0 && errno != EAGAIN && errno != EINTR))
+            {
+                c->failed = 1; // o servidor fechou antes de responder tudo
+                break;
+            }
+            have += n > 0 ? (size_t)n : 0;
+            size_t at = 0;
+            while (have - at >= 4 && have - at - 4 >= server_get32(input + at))
+            {
+                uint32_t len = server_get32(input + at);
+                int status = len >= 8 ? (int)server_get32(input + at + 4) : SERVER_BAD_REQUEST;
+                double done = now_seconds();
+                int file = (int)(received % c->num_frames);
+                c->latencies[received] = done - sent_at[received % c->pipeline];
+                c->counts[status >= 0 && status < 6 ? status : 6]++;
+                if (c->first_status[file] == -2)
+                {
+                    c->first_status[file] = status;
+                }
+                c->mismatches += c->first_status[file] != status;
+                received++;
+                at += 4 + (size_t)len;
+            }
+            memmove(input, input + at, have - at);
+            have -= at;
+        }
+    }
+    close(fd);
+    free(sent_at);
+    free(input);
+    return NULL;
+}
+
+static int compare_doubles(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+int main(int argc, char *argv[])
+{
+    const char *socket_path = NULL;
+    int connections = 1, pipeline = 1;
+    long requests = 10000;
+    int first_file = argc;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
+        {
+            socket_path = argv[++i];
+        }
+        else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc)
+        {
+            connections = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-p") == 0 && i + 1 < argc)
+        {
+            pipeline = atoi(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+        {
+            requests = atol(argv[++i]);
+        }
+        else
+        {
+            first_file = i;
+            break;
+        }
+    }
+    int num_frames = argc - first_file;
+    if (socket_path == NULL || num_frames <= 0 || connections < 1 || pipeline < 1 || requests < 1)
+    {
+        printf("Uso: %s -u caminho_do_socket [-c conexoes] [-p pipeline] [-n requisicoes] arquivos...\n", argv[0]);
+        return 1;
+    }
+
+    Frame *frames = calloc((size_t)num_frames, sizeof(Frame));
+    Connection *conns = calloc((size_t)connections, sizeof(Connection));
+    pthread_t *threads = malloc((size_t)connections * sizeof(pthread_t));
+    double *latencies = malloc((size_t)requests * (size_t)connections * sizeof(double));
+    if (frames == NULL || conns == NULL || threads == NULL || latencies == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    for (int i = 0; i < num_frames; i++)
+    {
+        if (load_frame(&frames[i], argv[first_file + i]) != 0)
+        {
+            printf("Erro ao ler o arquivo '%s'.\n", argv[first_file + i]);
+            return 1;
+        }
+    }
+
+    double t0 = now_seconds();
+    for (int i = 0; i < connections; i++)
+    {
+        Connection *c = &conns[i];
+        c->socket_path = socket_path;
+        c->frames = frames;
+        c->num_frames = num_frames;
+        c->pipeline = pipeline;
+        c->requests = requests;
+        c->latencies = latencies + (size_t)i * (size_t)requests;
+        c->first_status = malloc((size_t)num_frames * sizeof(int));
+        if (c->first_status == NULL)
+        {
+            printf("Erro: Falha ao alocar memória!\n");
+            return 1;
+        }
+        for (int f = 0; f < num_frames; f++)
+        {
+            c->first_status[f] = -2;
+        }
+        pthread_create(&threads[i], NULL, run_connection, c);
+    }
+    long counts[7] = {0}, mismatches = 0;
+    int failed = 0;
+    for (int i = 0; i < connections; i++)
+    {
+        pthread_join(threads[i], NULL);
+        failed |= conns[i].failed;
+        mismatches += conns[i].mismatches;
+        for (int s = 0; s < 7; s++)
+        {
+            counts[s] += conns[i].counts[s];
+        }
+        free(conns[i].first_status);
+    }
+    double elapsed = now_seconds() - t0;
+    if (failed)
+    {
+        printf("Erro: Falha na comunicação com o servidor em '%s'.\n", socket_path);
+        return 1;
+    }
+
+    size_t total = (size_t)requests * (size_t)connections;
+    qsort(latencies, total, sizeof(double), compare_doubles);
+    printf("%zu requisicoes em %d conexoes (pipeline %d), %.3f s: %.0f requisicoes/s\n", total, connections, pipeline,
+           elapsed, total / elapsed);
+    printf("latencia: p50 %.1f us, p99 %.1f us, maximo %.1f us\n", latencies[total / 2] * 1e6,
+           latencies[total * 99 / 100] * 1e6, latencies[total - 1] * 1e6);
+    printf("respostas: %ld aceitas, %ld rejeitadas, %ld sem '$', %ld outras; %ld com veredito divergente\n",
+           counts[0], counts[1], counts[2], counts[3] + counts[4] + counts[5] + counts[6], mismatches);
+
+    for (int i = 0; i < num_frames; i++)
+    {
+        free(frames[i].data);
+    }
+    free(frames);
+    free(conns);
+    free(threads);
+    free(latencies);
+    return mismatches ? 2 : 0;
+}
@@ -1,42 +1,20 @@
 #include "parser.h"
-#include <ctype.h>
-
-const char *nonTerminals[] = {
-    "S", "MAIN", "FLIST", "FLISTP", "FDEF",
-    "PARLIST", "PARLISTP", "VARLIST", "VARLISTP",
-    "STMT", "ATRIBST", "PRINTST", "RETURNST",
-    "RETURNSTP", "IFSTMT", "IFSTMTTAIL",
-    "STMTLIST", "STMTLISTP",
-    "EXPR", "EXPRP",
-    "NUMEXPR", "NUMEXPRP",
-    "TERM", "TERMP",
-    "FACTOR", "FACTORP",
-    "PARLISTCALL", "PARLISTCALLP"
-};
-
-const char *terminals[] = {
-    "def", "int", "id", "num", "if", "else", "return", "print",
-    "{", "}", "(", ")", ",", ";", ":=",
-    "<", "<=", ">", ">=", "=", "<>", "==", "+", "-", "*", "/",
-    "$"
-};
-
-const char *table[MAX_NONTERMINALS][MAX_TERMINALS];
-
+#include "lexer.h"
+#include "arena.h"
+#include "writer.h"
+#include "parser_direct.h"
+#include "source.h"
+#include <inttypes.h>
+#include <time.h>
+
+// Buscas por nome via hash perfeito gerado em table_gen.c
 int getNonTerminalIndex(const char *symbol)
 {
     if (symbol == NULL)
     {
         return -1;
     }
-    for (int i = 0; i < MAX_NONTERMINALS; i++)
-    {
-        if (strcmp(nonTerminals[i], symbol) == 0)
-        {
-            return i;
-        }
-    }
-    return -1;
+    return nonterminal_lookup(symbol, strlen(symbol));
 }
 
 int getTerminalIndex(const char *symbol)
@@ -45,567 +23,1128 @@ int getTerminalIndex(const char *symbol)
     {
         return -1;
     }
-    for (int i = 0; i < MAX_TERMINALS; i++)
-    {
-        if (strcmp(terminals[i], symbol) == 0)
-        {
-            return i;
-        }
-    }
-    return -1;
+    return terminal_lookup(symbol, strlen(symbol));
 }
 
-int tokenize_production(const char *production, char tokens[][MAX_INPUT], int max_tokens) {
-    int count = 0;
-    const char *current = production;
-    char token[MAX_INPUT];
-    int token_index = 0;
+const char *symbol_name(symbol_t symbol)
+{
+    return IS_NONTERMINAL(symbol) ? nonTerminals[symbol - MAX_TERMINALS] : terminals[symbol];
+}
 
-    while (*current != '\0') {
-        if (isspace(*current)) {
-            // Ignorar espaços em branco
-            current++;
-        } else if (isalnum(*current) || *current == '_') { 
-            // Inicia um terminal ou não-terminal
-            token_index = 0;
-            while (isalnum(*current) || *current == '_') { // Aceita letras, números e '_'
-                token[token_index++] = *current++;
-            }
-            token[token_index] = '\0'; // Finaliza o token
-            if (count < max_tokens) {
-                strcpy(tokens[count++], token);
-            } else {
-                printf("Erro: Limite de tokens excedido!\n");
-                return -1;
-            }
-        } else {
-            // Verificar operadores compostos
-            if ((*current == ':' && *(current + 1) == '=') ||
-                (*current == '<' && (*(current + 1) == '=' || *(current + 1) == '>')) ||
-                (*current == '>' && *(current + 1) == '=') ||
-                (*current == '=' && *(current + 1) == '=')) {
-                token_index = 0;
-                token[token_index++] = *current++;
-                token[token_index++] = *current++;
-                token[token_index] = '\0';
-            } else {
-                // Trata caracteres únicos como tokens
-                token_index = 0;
-                token[token_index++] = *current++;
-                token[token_index] = '\0';
-            }
+// Tabelas de table_gen.c no formato comum a todas as gramáticas
+const ParseTables builtin_tables = {
+    MAX_NONTERMINALS, MAX_PRODUCTIONS, nonTerminals, productions, prod_symbols, &prod_table[0][0], follow_set,
+    &chain_table[0][0], chains, chain_symbols, chain_productions,
+};
 
-            if (count < max_tokens) {
-                strcpy(tokens[count++], token);
-            } else {
-                printf("Erro: Limite de tokens excedido!\n");
-                return -1;
-            }
-        }
+static const char *tables_symbol_name(const ParseTables *t, symbol_t symbol)
+{
+    return IS_NONTERMINAL(symbol) ? t->nonterminal_names[symbol - MAX_TERMINALS] : terminals[symbol];
+}
+
+// Contexto do analisador: todo o estado mutável de uma análise. A tabela é
+// constante e compartilhada, então contextos diferentes podem ser usados ao
+// mesmo tempo em threads diferentes sem sincronização.
+#define STACK_INITIAL_CAPACITY 1024
+// Buffer do trace: 256 KiB por contexto (um por thread nos modos lote,
+// dividido e servidor); maior não reduz o tempo do trace completo
+#define TRACE_BUFFER_SIZE (1 << 18)
+#define TREE_INITIAL_CAPACITY 1024
+
+// Recuperação de erros: um erro a menos de RECOVERY_QUIET_TOKENS tokens do
+// anterior não é relatado, o que corta erros em cascata. Os tokens de
+// sincronização encerram construções: nunca são descartados se algum símbolo
+// da pilha puder aceitá-los.
+#define RECOVERY_QUIET_TOKENS 3
+#define SYNC_TOKENS ((1u << T_SEMICOLON) | (1u << T_RBRACE) | (1u << T_DEF) | (1u << T_END))
+
+// Contadores (ParserStats): com -DPARSER_STATS, STATS(...) vira o próprio
+// código; sem a flag, desaparece do laço
+#ifdef PARSER_STATS
+#define STATS(...) __VA_ARGS__
+#else
+#define STATS(...)
+#endif
+
+struct Parser
+{
+    // Pilha de símbolos alocada na arena; crescimento geométrico
+    Arena arena;
+    symbol_t *stack;
+    size_t stack_capacity;
+    long top;
+
+    TokenArray tokens; // reaproveitado entre chamadas de parser_parse_buffer
+    const char *src;   // fonte da última análise (para as mensagens de erro)
+
+    int verbosity;
+    Writer out;
+    ParseResult result;
+
+    // Expansões encadeadas (chain_table): ligadas por padrão; sem efeito com
+    // árvore ou trace completo, que precisam de cada produção separada
+    int chains;
+
+    // Árvore sintática opcional, também na arena: liberada em O(1) junto com o
+    // resto da análise. node_stack guarda o nó de cada símbolo da pilha.
+    int build_tree;
+    uint32_t *node_stack;
+    TreeNode *nodes;
+    uint32_t node_capacity;
+    ParseTree tree;
+
+    // Recuperação de erros (modo pânico): todos os erros relatados, na arena
+    int recovery;
+    ParseResult *errors;
+    size_t num_errors;
+    size_t error_capacity;
+    size_t last_error; // índice do token do último erro, relatado ou não
+    SourceMap lines;   // linhas do fonte, indexadas só quando um erro é relatado
+
+    // Pilha do motor gerado (parser_direct.c), fora da arena para ser
+    // reaproveitada entre análises
+    DirectStack direct;
+
+    // Análise em fluxo (parser_feed): tokens já recebidos
+    size_t fed;
+
+    ParserStats stats;
+
+    const ParseTables *tables;
+};
+
+Parser *parser_create(void)
+{
+    Parser *p = counted_malloc(sizeof(Parser));
+    if (p == NULL) {
+        return NULL;
     }
+    memset(p, 0, sizeof(*p));
+    p->out.buf = counted_malloc(TRACE_BUFFER_SIZE);
+    if (p->out.buf == NULL) {
+        free(p);
+        return NULL;
+    }
+    p->out.cap = TRACE_BUFFER_SIZE;
+    p->out.fp = stdout;
+    p->verbosity = TRACE_NONE;
+    p->chains = 1;
+    p->tables = &builtin_tables;
+    p->top = -1;
+    STATS(p->stats.enabled = 1);
+    return p;
+}
 
-    return count; // Retorna o número de tokens encontrados
+void parser_set_verbosity(Parser *p, int verbosity)
+{
+    p->verbosity = verbosity;
 }
 
-void initialize_table()
+// Liga ou desliga a construção da árvore sintática nas próximas análises
+void parser_set_build_tree(Parser *p, int enabled)
 {
-    for (int i = 0; i < MAX_NONTERMINALS; i++)
-    {
-        for (int j = 0; j < MAX_TERMINALS; j++)
-        {
-            table[i][j] = NULL;
-        }
+    p->build_tree = enabled;
+}
+
+// Liga ou desliga a recuperação de erros: com ela, a análise continua depois
+// de cada erro sintático e parser_errors devolve todos os erros relatados
+void parser_set_recovery(Parser *p, int enabled)
+{
+    p->recovery = enabled;
+}
+
+// Liga ou desliga as expansões encadeadas; o resultado e o trace até o nível
+// TRACE_MATCHES são os mesmos, muda só o número de passos do laço
+void parser_set_chains(Parser *p, int enabled)
+{
+    p->chains = enabled;
+}
+
+// Troca a gramática das próximas análises; as tabelas precisam continuar
+// válidas enquanto o contexto as usar
+void parser_set_tables(Parser *p, const ParseTables *tables)
+{
+    p->tables = tables;
+}
+
+void parser_set_output(Parser *p, FILE *fp)
+{
+    writer_flush(&p->out);
+    p->out.fp = fp;
+}
+
+// Descarta o estado da última análise; a memória fica reservada para a próxima
+void parser_reset(Parser *p)
+{
+    arena_reset(&p->arena);
+    p->stack = NULL;
+    p->stack_capacity = 0;
+    p->top = -1;
+    p->tokens.count = 0;
+    p->src = NULL;
+    source_map_reset(&p->lines, NULL);
+    memset(&p->result, 0, sizeof(p->result));
+    p->node_stack = NULL;
+    p->nodes = NULL;
+    p->node_capacity = 0;
+    memset(&p->tree, 0, sizeof(p->tree));
+    p->errors = NULL;
+    p->num_errors = 0;
+    p->error_capacity = 0;
+}
+
+void parser_destroy(Parser *p)
+{
+    if (p == NULL) {
+        return;
     }
+    writer_flush(&p->out);
+    arena_free(&p->arena);
+    token_array_free(&p->tokens);
+    source_map_free(&p->lines);
+    free(p->direct.data);
+    free(p->out.buf);
+    free(p);
+}
 
-    int r, c; // row (não-terminal), col (terminal)
+const ParseResult *parser_result(const Parser *p)
+{
+    return &p->result;
+}
 
-    // S ::= MAIN
-    r = getNonTerminalIndex("S");
-    {
-        const char *s_first[] = {"def", "int", "id", "print", "return", "if", "{", ";"};
-        int nf = sizeof(s_first) / sizeof(s_first[0]);
-        for (int i = 0; i < nf; i++)
-        {
-            c = getTerminalIndex(s_first[i]);
-            if (c >= 0)
-                table[r][c] = "MAIN";
-        }
-        // MAIN pode derivar ε, adicionar FOLLOW(S) = {$}
-        c = getTerminalIndex("$");
-        if (c >= 0)
-            table[r][c] = "MAIN";
+// Árvore da última análise; vazia se ela não foi aceita ou se a construção
+// estava desligada. Válida até a próxima análise ou parser_reset.
+const ParseTree *parser_tree(const Parser *p)
+{
+    return &p->tree;
+}
+
+// Erros sintáticos da última análise, em ordem do fonte (com a recuperação
+// desligada, no máximo um). Válidos até a próxima análise ou parser_reset.
+const ParseResult *parser_errors(const Parser *p, size_t *count)
+{
+    *count = p->num_errors;
+    return p->errors;
+}
+
+// Número de tokens da última chamada a parser_parse_buffer
+size_t parser_token_count(const Parser *p)
+{
+    return p->tokens.count;
+}
+
+// Tokens da última chamada a parser_parse_buffer (válidos até a próxima análise)
+const TokenArray *parser_tokens(const Parser *p)
+{
+    return &p->tokens;
+}
+
+static void log_pilha(Parser *p) {
+    writer_puts(&p->out, "PILHA ATUAL: ");
+    for (long i = p->top; i >= 0; i--) {
+        writer_puts(&p->out, tables_symbol_name(p->tables, p->stack[i]));
+        writer_putc(&p->out, ' ');
     }
+    writer_putc(&p->out, '\n');
+}
 
-    // MAIN ::= STMT | FLIST | ''
-    r = getNonTerminalIndex("MAIN");
-    {
-        // MAIN ::= STMT
-        const char *main_stmt_first[] = {"int", "id", "print", "return", "if", "{", ";"};
-        int nm = sizeof(main_stmt_first) / sizeof(main_stmt_first[0]);
-        for (int i = 0; i < nm; i++)
-        {
-            c = getTerminalIndex(main_stmt_first[i]);
-            if (c >= 0)
-                table[r][c] = "STMT";
+// Dobra a capacidade da pilha; a memória vem da arena, reaproveitada entre execuções
+static int grow_stack(Parser *p) {
+    symbol_t *bigger = arena_alloc(&p->arena, p->stack_capacity * 2 * sizeof(symbol_t));
+    if (bigger == NULL) {
+        return -1;
+    }
+    memcpy(bigger, p->stack, (size_t)(p->top + 1) * sizeof(symbol_t));
+    if (p->build_tree) {
+        uint32_t *nodes = arena_alloc(&p->arena, p->stack_capacity * 2 * sizeof(uint32_t));
+        if (nodes == NULL) {
+            return -1;
         }
+        memcpy(nodes, p->node_stack, (size_t)(p->top + 1) * sizeof(uint32_t));
+        p->node_stack = nodes;
+    }
+    p->stack = bigger;
+    p->stack_capacity *= 2;
+    return 0;
+}
 
-        // MAIN ::= FLIST
-        const char *main_flist_first[] = {"def"};
-        int nf = sizeof(main_flist_first) / sizeof(main_flist_first[0]);
-        for (int i = 0; i < nf; i++)
-        {
-            c = getTerminalIndex(main_flist_first[i]);
-            if (c >= 0)
-                table[r][c] = "FLIST";
-        }
+// O laço do parser é instanciado com e sem a construção da árvore
+#define PARSER_INLINE static inline __attribute__((always_inline))
 
-        // MAIN ::= ''
-        // FOLLOW(MAIN) = FOLLOW(S) = {$}
-        c = getTerminalIndex("$");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+//Adiciona um símbolo (e o seu nó, se houver árvore) ao topo da pilha. Retorna -1 se faltar memória.
+PARSER_INLINE int push(Parser *p, symbol_t symbol, uint32_t node, const int build_tree) {
+    if ((size_t)(p->top + 1) == p->stack_capacity && grow_stack(p) != 0) {
+        return -1;
     }
+    p->stack[++p->top] = symbol;
+    if (build_tree) {
+        p->node_stack[p->top] = node;
+    }
+    return 0;
+}
 
-    // FLIST ::= FDEF FLISTP
-    r = getNonTerminalIndex("FLIST");
-    c = getTerminalIndex("def");
-    if (c >= 0)
-        table[r][c] = "FDEF FLISTP";
-
-    // FLISTP ::= FDEF FLISTP | ''
-    r = getNonTerminalIndex("FLISTP");
-    {
-        // FLISTP ::= FDEF FLISTP
-        const char *flistp_def_first[] = {"def"};
-        int nf = sizeof(flistp_def_first) / sizeof(flistp_def_first[0]);
-        for (int i = 0; i < nf; i++)
-        {
-            c = getTerminalIndex(flistp_def_first[i]);
-            if (c >= 0)
-                table[r][c] = "FDEF FLISTP";
+// Garante espaço para mais 'extra' símbolos na pilha
+PARSER_INLINE int reserve_stack(Parser *p, size_t extra) {
+    while ((size_t)(p->top + 1) + extra > p->stack_capacity) {
+        if (grow_stack(p) != 0) {
+            return -1;
         }
+    }
+    return 0;
+}
 
-        // FLISTP ::= ''
-        // FOLLOW(FLISTP) = FOLLOW(FLIST) = {$}
-        c = getTerminalIndex("$");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+// Garante espaço para mais 'extra' nós; o vetor dobra dentro da arena
+static int reserve_nodes(Parser *p, uint32_t extra) {
+    if (p->tree.count + extra <= p->node_capacity) {
+        return 0;
+    }
+    uint32_t capacity = p->node_capacity * 2;
+    if (capacity < p->tree.count + extra || capacity < p->node_capacity) {
+        return -1;
+    }
+    TreeNode *bigger = arena_alloc(&p->arena, (size_t)capacity * sizeof(TreeNode));
+    if (bigger == NULL) {
+        return -1;
     }
+    memcpy(bigger, p->nodes, (size_t)p->tree.count * sizeof(TreeNode));
+    p->nodes = bigger;
+    p->tree.nodes = bigger;
+    p->node_capacity = capacity;
+    return 0;
+}
 
-    // FDEF ::= def id ( PARLIST ) { STMTLIST }
-    r = getNonTerminalIndex("FDEF");
-    c = getTerminalIndex("def");
-    if (c >= 0)
-        table[r][c] = "def id ( PARLIST ) { STMTLIST }";
+// Fim (exclusivo) do trecho de tokens do nó: desce pelos últimos filhos até um
+// terminal (que cobre um token) ou um não-terminal vazio (que não cobre nenhum)
+uint32_t parse_tree_token_end(const ParseTree *tree, uint32_t index)
+{
+    const TreeNode *node = &tree->nodes[index];
+    while (node->num_children > 0) {
+        node = &tree->nodes[node->first_child + node->num_children - 1];
+    }
+    return IS_NONTERMINAL(node->symbol) ? node->token_begin : node->token_begin + 1;
+}
 
-    // PARLIST ::= int id PARLIST' | ''
-    r = getNonTerminalIndex("PARLIST");
+//Retorna o símbolo no topo da pilha sem removê-lo, ou -1 se ela estiver vazia.
+static inline int peek(const Parser *p)
+{
+    if (p->top >= 0)
     {
-        // PARLIST ::= int id PARLIST'
-        const char *parlist_int_first[] = {"int"};
-        int ni = sizeof(parlist_int_first) / sizeof(parlist_int_first[0]);
-        for (int i = 0; i < ni; i++)
-        {
-            c = getTerminalIndex(parlist_int_first[i]);
-            if (c >= 0)
-                table[r][c] = "int id PARLISTP";
-        }
-
-        // PARLIST ::= ''
-        // FOLLOW(PARLIST) = {")"}
-        c = getTerminalIndex(")");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+        return p->stack[p->top];
+    }
+    else
+    {
+        return -1;
     }
+}
 
-    // PARLISTP ::= , int id PARLIST' | ''
-    r = getNonTerminalIndex("PARLISTP");
+// Escreve o token: nome do terminal ou, se inválido, o próprio lexema
+static void write_token(Writer *w, const char *src, const Token *tk)
+{
+    if (tk == NULL)
     {
-        // PARLISTP ::= , int id PARLIST'
-        const char *parlistp_comma_first[] = {","};
-        int nc = sizeof(parlistp_comma_first) / sizeof(parlistp_comma_first[0]);
-        for (int i = 0; i < nc; i++)
-        {
-            c = getTerminalIndex(parlistp_comma_first[i]);
-            if (c >= 0)
-                table[r][c] = ", int id PARLISTP";
+        writer_puts(w, "EOF");
+    }
+    else if (tk->type == T_INVALID)
+    {
+        writer_write(w, src + tk->offset, tk->length);
+    }
+    else
+    {
+        writer_puts(w, terminals[tk->type]);
+    }
+}
+
+static int format_result(const ParseTables *t, const ParseResult *r, const char *src, char *buf, size_t size)
+{
+    char token[64];
+    if (r->status == PARSE_SYNTAX_ERROR) {
+        if (r->has_token && r->token_type == T_INVALID && src == NULL) {
+            snprintf(token, sizeof(token), "token inválido");
+        } else if (r->has_token && r->token_type == T_INVALID) {
+            snprintf(token, sizeof(token), "%.*s", (int)(r->length < 60 ? r->length : 60), src + r->offset);
+        } else {
+            snprintf(token, sizeof(token), "%s", r->has_token ? terminals[r->token_type] : "EOF");
         }
+    }
 
-        // PARLISTP ::= ''
-        // FOLLOW(PARLISTP) = {")"}
-        c = getTerminalIndex(")");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+    switch (r->status) {
+    case PARSE_ACCEPTED:
+        return snprintf(buf, size, "Entrada aceita!");
+    case PARSE_SYNTAX_ERROR:
+        if (r->expected >= 0) {
+            return snprintf(buf, size, "Erro sintático: Esperava '%s', obteve '%s'", terminals[r->expected], token);
+        }
+        return snprintf(buf, size, "Erro sintático: Não há produção para <%s> com lookahead '%s'",
+                        t->nonterminal_names[r->nonterminal], token);
+    case PARSE_NO_END_MARKER:
+        return snprintf(buf, size, "Erro: Entrada não terminou em $!");
+    case PARSE_EMPTY_STACK:
+        return snprintf(buf, size, "Erro: Pilha vazia antes do fim da entrada!");
+    case PARSE_INPUT_TOO_LARGE:
+        return snprintf(buf, size, "Erro: O arquivo de entrada é muito grande (limite de 4 GiB).");
+    case PARSE_OUT_OF_MEMORY:
+    default:
+        return snprintf(buf, size, "Erro: Falha ao alocar memória!");
     }
+}
 
-    // VARLIST ::= id VARLIST'
-    r = getNonTerminalIndex("VARLIST");
-    c = getTerminalIndex("id");
-    if (c >= 0)
-        table[r][c] = "id VARLISTP";
+// Formata a mensagem de um resultado (veredito ou diagnóstico), sem quebra de
+// linha. src é o fonte analisado, usado para mostrar lexemas inválidos.
+int parse_result_message(const ParseResult *r, const char *src, char *buf, size_t size)
+{
+    return format_result(&builtin_tables, r, src, buf, size);
+}
 
-    // VARLISTP ::= , id VARLIST' | ''
-    r = getNonTerminalIndex("VARLISTP");
-    {
-        // VARLISTP ::= , id VARLIST'
-        const char *varlistp_comma_first[] = {","};
-        int nc = sizeof(varlistp_comma_first) / sizeof(varlistp_comma_first[0]);
-        for (int i = 0; i < nc; i++)
-        {
-            c = getTerminalIndex(varlistp_comma_first[i]);
-            if (c >= 0)
-                table[r][c] = ", id VARLISTP";
-        }
+// Mensagem da última análise. O fonte passado a ela precisa continuar válido.
+int parser_message(const Parser *p, char *buf, size_t size)
+{
+    return format_result(p->tables, &p->result, p->src, buf, size);
+}
 
-        // VARLISTP ::= ''
-        // FOLLOW(VARLISTP) = {";", "}"}
-        const char *varlistp_follow[] = {";", "}"};
-        int nvf = sizeof(varlistp_follow) / sizeof(varlistp_follow[0]);
-        for (int i = 0; i < nvf; i++)
-        {
-            c = getTerminalIndex(varlistp_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
+// Guarda o erro na lista da análise; -1 se faltar memória
+static int record_error(Parser *p, const ParseResult *r)
+{
+    if (p->num_errors == p->error_capacity) {
+        size_t capacity = p->error_capacity ? p->error_capacity * 2 : 16;
+        ParseResult *bigger = arena_alloc(&p->arena, capacity * sizeof(ParseResult));
+        if (bigger == NULL) {
+            return -1;
+        }
+        if (p->num_errors > 0) {
+            memcpy(bigger, p->errors, p->num_errors * sizeof(ParseResult));
         }
+        p->errors = bigger;
+        p->error_capacity = capacity;
     }
+    p->errors[p->num_errors++] = *r;
+    return 0;
+}
 
-    // STMT ::= int VARLIST ; | ATRIBST ; | PRINTST ; | RETURNST ; | IFSTMT | { STMTLIST } | ;
-    r = getNonTerminalIndex("STMT");
-    {
-        // STMT ::= int VARLIST ;
-        c = getTerminalIndex("int");
-        if (c >= 0)
-            table[r][c] = "int VARLIST ;";
-
-        // STMT ::= ATRIBST ;
-        c = getTerminalIndex("id");
-        if (c >= 0)
-            table[r][c] = "ATRIBST ;";
-
-        // STMT ::= PRINTST ;
-        c = getTerminalIndex("print");
-        if (c >= 0)
-            table[r][c] = "PRINTST ;";
-
-        // STMT ::= RETURNST ;
-        c = getTerminalIndex("return");
-        if (c >= 0)
-            table[r][c] = "RETURNST ;";
-
-        // STMT ::= IFSTMT
-        c = getTerminalIndex("if");
-        if (c >= 0)
-            table[r][c] = "IFSTMT";
-
-        // STMT ::= { STMTLIST }
-        c = getTerminalIndex("{");
-        if (c >= 0)
-            table[r][c] = "{ STMTLIST }";
-
-        // STMT ::= ;
-        c = getTerminalIndex(";");
-        if (c >= 0)
-            table[r][c] = ";";
-    }
-
-    // ATRIBST ::= id := EXPR
-    r = getNonTerminalIndex("ATRIBST");
-    c = getTerminalIndex("id");
-    if (c >= 0)
-        table[r][c] = "id := EXPR";
-
-    // PRINTST ::= print EXPR
-    r = getNonTerminalIndex("PRINTST");
-    c = getTerminalIndex("print");
-    if (c >= 0)
-        table[r][c] = "print EXPR";
-
-    // RETURNST ::= return RETURNST'
-    r = getNonTerminalIndex("RETURNST");
-    c = getTerminalIndex("return");
-    if (c >= 0)
-    {
-        // RETURNST ::= return RETURNST'
-        table[r][c] = "return RETURNSTP";
+// Registra um erro sintático no token atual. Com a recuperação ligada, erros
+// logo depois de outro (em cascata) são silenciados.
+static ParseStatus syntax_error(Parser *p, const Token *current, size_t index, int expected, int nonterminal)
+{
+    size_t last = p->last_error;
+    p->last_error = index;
+    if (p->num_errors > 0 && index - last < RECOVERY_QUIET_TOKENS) {
+        return PARSE_SYNTAX_ERROR;
+    }
 
-        // RETURNST ::= return
-        // FOLLOW(RETURNST) = {";"}
-        c = getTerminalIndex(";");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "return";
+    ParseResult r;
+    r.status = PARSE_SYNTAX_ERROR;
+    r.token_index = index;
+    r.has_token = current != NULL;
+    r.token_type = current ? current->type : T_INVALID;
+    r.offset = current ? current->offset : 0;
+    r.length = current ? current->length : 0;
+    r.expected = expected;
+    r.nonterminal = nonterminal;
+    if (p->num_errors == 0) {
+        p->result = r;
+    }
+    if (record_error(p, &r) != 0) {
+        return PARSE_OUT_OF_MEMORY;
     }
 
-    // RETURNST' ::= id | ''
-    r = getNonTerminalIndex("RETURNSTP");
-    {
-        // RETURNST' ::= id
-        c = getTerminalIndex("id");
-        if (c >= 0)
-            table[r][c] = "id";
-
-        // RETURNST' ::= ''
-        // FOLLOW(RETURNST') = {";"}
-        c = getTerminalIndex(";");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
-    }
-
-    // IFSTMT ::= if ( EXPR ) STMT IFSTMTTAIL
-    r = getNonTerminalIndex("IFSTMT");
-    c = getTerminalIndex("if");
-    if (c >= 0)
-        table[r][c] = "if ( EXPR ) STMT IFSTMTTAIL";
-
-    // IFSTMTTAIL ::= else STMT | ''
-    r = getNonTerminalIndex("IFSTMTTAIL");
-    {
-        // IFSTMTTAIL ::= else STMT
-        c = getTerminalIndex("else");
-        if (c >= 0)
-            table[r][c] = "else STMT";
-
-        // IFSTMTTAIL ::= ''
-        // FOLLOW(IFSTMTTAIL) = {";", "}"}
-        const char *ifstmttail_follow[] = {";", "}"};
-        int nft = sizeof(ifstmttail_follow) / sizeof(ifstmttail_follow[0]);
-        for (int i = 0; i < nft; i++)
-        {
-            c = getTerminalIndex(ifstmttail_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
+    if (p->verbosity >= TRACE_QUIET) {
+        Writer *w = &p->out;
+        if (expected >= 0) {
+            writer_puts(w, "Erro sintático: Esperava '");
+            writer_puts(w, terminals[expected]);
+            writer_puts(w, "', obteve '");
+        } else {
+            writer_puts(w, "Erro sintático: Não há produção para <");
+            writer_puts(w, p->tables->nonterminal_names[nonterminal]);
+            writer_puts(w, "> com lookahead '");
+        }
+        write_token(w, p->src, current);
+        writer_putc(w, '\'');
+        SourcePosition pos;
+        if (p->recovery && current != NULL && source_map_locate(&p->lines, r.offset, &pos) == 0) {
+            char position[64];
+            snprintf(position, sizeof(position), " (linha %u, coluna %u)", pos.line, pos.column);
+            writer_puts(w, position);
         }
+        writer_putc(w, '\n');
     }
+    return PARSE_SYNTAX_ERROR;
+}
 
-    // STMTLIST ::= STMT STMTLIST'
-    r = getNonTerminalIndex("STMTLIST");
-    {
-        const char *stmtlist_first[] = {"int", "id", "print", "return", "if", "{", ";"};
-        int n_stmt = sizeof(stmtlist_first) / sizeof(stmtlist_first[0]);
-        for (int i = 0; i < n_stmt; i++)
-        {
-            c = getTerminalIndex(stmtlist_first[i]);
-            if (c >= 0)
-                table[r][c] = "STMT STMTLISTP";
+// Algum símbolo abaixo do topo da pilha aceita o terminal type?
+static int stack_accepts(const Parser *p, int type)
+{
+    const uint8_t *table = p->tables->prod_table;
+    for (long i = p->top - 1; i >= 0; i--) {
+        symbol_t s = p->stack[i];
+        if (IS_NONTERMINAL(s) ? table[(s - MAX_TERMINALS) * MAX_TERMINALS + type] != NO_PRODUCTION : s == type) {
+            return 1;
         }
     }
+    return 0;
+}
 
-    // STMTLISTP ::= STMT STMTLIST' | ''
-    r = getNonTerminalIndex("STMTLISTP");
-    {
-        // STMTLISTP ::= STMT STMTLISTP
-        const char *stmtlistp_first[] = {"int", "id", "print", "return", "if", "{", ";"};
-        int n_stmtp = sizeof(stmtlistp_first) / sizeof(stmtlistp_first[0]);
-        for (int i = 0; i < n_stmtp; i++)
-        {
-            c = getTerminalIndex(stmtlistp_first[i]);
-            if (c >= 0)
-                table[r][c] = "STMT STMTLISTP";
-        }
+static int is_sync_token(int type)
+{
+    return type < 32 && ((SYNC_TOKENS >> type) & 1);
+}
 
-        // STMTLISTP ::= ''
-        // FOLLOW(STMTLISTP) = {"}"}
-        c = getTerminalIndex("}");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+// Trace das ações de recuperação
+static void log_recovery(Parser *p, const char *action, const char *what)
+{
+    if (p->verbosity >= TRACE_MATCHES) {
+        writer_puts(&p->out, "Recuperação: ");
+        writer_puts(&p->out, action);
+        writer_puts(&p->out, what);
+        writer_putc(&p->out, '\n');
     }
+}
 
-    // EXPR ::= NUMEXPR EXPR'
-    r = getNonTerminalIndex("EXPR");
-    {
-        const char *expr_first[] = {"id", "num", "("};
-        int ne = sizeof(expr_first) / sizeof(expr_first[0]);
-        for (int i = 0; i < ne; i++)
-        {
-            c = getTerminalIndex(expr_first[i]);
-            if (c >= 0)
-                table[r][c] = "NUMEXPR EXPRP";
+static void log_production(Writer *out, const ParseTables *t, const Production *production)
+{
+    writer_puts(out, "Produção usada: ");
+    writer_puts(out, t->nonterminal_names[production->lhs]);
+    writer_puts(out, " -> ");
+    writer_puts(out, (production->length > 0) ? production->text : "ε");
+    writer_putc(out, '\n');
+}
+
+#ifdef PARSER_STATS
+static double stats_clock(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static void count_production(ParserStats *s, const ParseTables *t, int production, int col)
+{
+    if (t == &builtin_tables) {
+        s->cells[productions[production].lhs][col]++;
+    }
+    s->productions++;
+    s->epsilon += t->productions[production].length == 0;
+}
+
+static void count_depth(ParserStats *s, long top)
+{
+    if ((uint64_t)(top + 1) > s->max_depth) {
+        s->max_depth = (uint64_t)(top + 1);
+    }
+}
+#endif
+
+static ParseStatus finish(Parser *p, ParseStatus status)
+{
+    if (status == PARSE_ACCEPTED && p->num_errors > 0) {
+        status = PARSE_SYNTAX_ERROR; // chegou ao fim depois de se recuperar de erros
+    }
+    if (status == PARSE_SYNTAX_ERROR && p->recovery && p->verbosity >= TRACE_QUIET) {
+        char message[64];
+        snprintf(message, sizeof(message), "%zu erro(s) sintático(s).\n", p->num_errors);
+        writer_puts(&p->out, message);
+    }
+    p->result.status = status;
+    if (status != PARSE_ACCEPTED) {
+        p->tree.count = 0; // árvore parcial não é exposta
+    }
+    if (p->verbosity >= TRACE_QUIET && status != PARSE_SYNTAX_ERROR) {
+        char message[128];
+        parser_message(p, message, sizeof(message));
+        writer_puts(&p->out, message);
+        writer_putc(&p->out, '\n');
+    }
+    writer_flush(&p->out);
+    return status;
+}
+
+// Estado inicial de uma análise: arena, resultado e lista de erros vazios
+static void begin_parse(Parser *p, const char *src)
+{
+    arena_reset(&p->arena);
+    memset(&p->result, 0, sizeof(p->result));
+    p->result.expected = -1;
+    p->result.nonterminal = -1;
+    p->errors = NULL;
+    p->num_errors = 0;
+    p->error_capacity = 0;
+    p->last_error = 0;
+    p->src = src;
+    source_map_reset(&p->lines, src);
+}
+
+// Analisa inputTokens[begin, inputCount) a partir do não-terminal start. A saída
+// depende do nível de verbosidade (veredito, produções, matches, pilha e entrada).
+// Se end_marker não for NULL, ele é o lookahead depois do último token: um '$'
+// virtual no fim do trecho, ou o primeiro token do trecho seguinte, e então o
+// trecho é aceito quando, consumido inteiro, a análise poderia continuar nele. Com build_tree, cada produção aplicada cria os
+// nós dos seus símbolos, consecutivos, e cada match registra o token do nó.
+// Com use_chains, cada expansão aplica a cadeia inteira da célula (até o
+// primeiro match) num único passo. t são as tabelas do contexto; passar
+// &builtin_tables como constante deixa o compilador usar os endereços das
+// tabelas de table_gen.c diretamente.
+PARSER_INLINE ParseStatus run_loop(Parser *p, const ParseTables *t, const char *src, const Token *inputTokens,
+                                   size_t begin, size_t inputCount, int start, const Token *end_marker,
+                                   const int build_tree, const int use_chains) {
+    const int verbosity = p->verbosity;
+    Writer *out = &p->out;
+    const uint8_t *table = t->prod_table;
+
+    size_t inputIndex = begin;
+
+    begin_parse(p, src);
+    p->stack_capacity = STACK_INITIAL_CAPACITY;
+    p->stack = arena_alloc(&p->arena, p->stack_capacity * sizeof(symbol_t));
+    p->top = -1;
+    memset(&p->tree, 0, sizeof(p->tree));
+    p->tree.tables = t;
+    if (p->stack == NULL) {
+        return finish(p, PARSE_OUT_OF_MEMORY);
+    }
+    if (build_tree) {
+        p->node_stack = arena_alloc(&p->arena, p->stack_capacity * sizeof(uint32_t));
+        // Começa com a capacidade da análise anterior, ou cerca de 3 nós por
+        // token, para evitar cópias ao dobrar o vetor
+        size_t estimate = 3 * (inputCount - begin) + 1;
+        if (p->node_capacity < estimate) {
+            p->node_capacity = estimate < UINT32_MAX ? (uint32_t)estimate : UINT32_MAX;
+        }
+        if (p->node_capacity < TREE_INITIAL_CAPACITY) {
+            p->node_capacity = TREE_INITIAL_CAPACITY;
+        }
+        p->nodes = arena_alloc(&p->arena, p->node_capacity * sizeof(TreeNode));
+        if (p->node_stack == NULL || p->nodes == NULL) {
+            return finish(p, PARSE_OUT_OF_MEMORY);
         }
+        p->tree.nodes = p->nodes;
+        p->tree.count = 1;
+        p->nodes[0] = (TreeNode){TREE_NONE, (uint32_t)begin, SYM_NONTERMINAL(start), 0, NO_PRODUCTION};
     }
 
-    // EXPR' ::= < NUMEXPR | <= NUMEXPR | > NUMEXPR | >= NUMEXPR | == NUMEXPR | <> NUMEXPR | ''
-    r = getNonTerminalIndex("EXPRP");
-    {
-        const char *exprp_ops[] = {"<", "<=", ">", ">=", "==", "<>"};
-        const char *exprp_prods[] = {
-            "< NUMEXPR",
-            "<= NUMEXPR",
-            "> NUMEXPR",
-            ">= NUMEXPR",
-            "== NUMEXPR",
-            "<> NUMEXPR"
-        };
-        int n_exprp_ops = sizeof(exprp_ops) / sizeof(exprp_ops[0]);
-        for (int i = 0; i < n_exprp_ops; i++)
-        {
-            c = getTerminalIndex(exprp_ops[i]);
-            if (c >= 0)
-                table[r][c] = exprp_prods[i];
+    push(p, T_END, TREE_NONE, build_tree);
+    push(p, SYM_NONTERMINAL(start), 0, build_tree);
+    STATS(count_depth(&p->stats, p->top));
+
+    if (verbosity >= TRACE_PRODUCTIONS) writer_puts(out, "Iniciando parsing...\n\n");
+
+    while (1) {
+        int top_symbol = peek(p);
+        const Token *current_input = (inputIndex < inputCount) ? &inputTokens[inputIndex] : end_marker;
+
+        if (top_symbol == -1) {
+            return finish(p, PARSE_EMPTY_STACK);
         }
 
-        // EXPR' ::= ''
-        // FOLLOW(EXPR') = {";", ")", "}", ","}
-        const char *exprp_follow[] = {";", ")", "}", ","};
-        int n_exprp_follow = sizeof(exprp_follow) / sizeof(exprp_follow[0]);
-        for (int i = 0; i < n_exprp_follow; i++)
-        {
-            c = getTerminalIndex(exprp_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
+        if (top_symbol == T_END) {
+            if (current_input != NULL && current_input->type == T_END) {
+                p->top--;
+                return finish(p, PARSE_ACCEPTED);
+            }
+            if (p->recovery && current_input != NULL) {
+                // Sobra depois do fim do programa: relata e descarta até o '$'
+                if (syntax_error(p, current_input, inputIndex, T_END, -1) == PARSE_OUT_OF_MEMORY) {
+                    return finish(p, PARSE_OUT_OF_MEMORY);
+                }
+                while (inputIndex < inputCount && inputTokens[inputIndex].type != T_END) {
+                    inputIndex++;
+                }
+                log_recovery(p, "descartados os tokens até ", "$");
+                continue;
+            }
+            return finish(p, PARSE_NO_END_MARKER);
         }
-    }
 
-    // NUMEXPR ::= TERM NUMEXPR'
-    r = getNonTerminalIndex("NUMEXPR");
-    {
-        const char *numexpr_first[] = {"id", "num", "("};
-        int nn = sizeof(numexpr_first) / sizeof(numexpr_first[0]);
-        for (int i = 0; i < nn; i++)
-        {
-            c = getTerminalIndex(numexpr_first[i]);
-            if (c >= 0)
-                table[r][c] = "TERM NUMEXPRP";
+        if (!IS_NONTERMINAL(top_symbol)) {
+            // Símbolo do topo é terminal
+            if (current_input != NULL && current_input->type == top_symbol) {
+                if (verbosity >= TRACE_MATCHES) {
+                    writer_puts(out, "Match: ");
+                    writer_puts(out, terminals[top_symbol]);
+                    writer_putc(out, '\n');
+                }
+                if (build_tree) {
+                    p->nodes[p->node_stack[p->top]] =
+                        (TreeNode){TREE_NONE, (uint32_t)inputIndex, (symbol_t)top_symbol, 0, NO_PRODUCTION};
+                }
+                p->top--;
+                if (verbosity >= TRACE_FULL) log_pilha(p);
+                STATS(p->stats.matches++);
+                inputIndex++;
+            } else {
+                ParseStatus status = syntax_error(p, current_input, inputIndex, top_symbol, -1);
+                if (!p->recovery || current_input == NULL || status == PARSE_OUT_OF_MEMORY) {
+                    return finish(p, status);
+                }
+                // Terminal ausente se o token fecha uma construção ou serve ao
+                // que vem depois na pilha; senão o token é que está sobrando
+                int type = current_input->type;
+                if (type != T_INVALID && (is_sync_token(type) || stack_accepts(p, type))) {
+                    log_recovery(p, "removido da pilha ", terminals[top_symbol]);
+                    p->top--;
+                } else {
+                    log_recovery(p, "descartado ", type != T_INVALID ? terminals[type] : "token inválido");
+                    inputIndex++;
+                }
+                continue;
+            }
+        } else {
+            // Símbolo do topo é não-terminal
+            int row = top_symbol - MAX_TERMINALS;
+            int col = (current_input != NULL && current_input->type != T_INVALID) ? current_input->type : -1;
+
+            if (col == -1 || table[row * MAX_TERMINALS + col] == NO_PRODUCTION) {
+                ParseStatus status = syntax_error(p, current_input, inputIndex, -1, row);
+                if (!p->recovery || current_input == NULL || status == PARSE_OUT_OF_MEMORY) {
+                    return finish(p, status);
+                }
+                // Sincroniza: desiste do não-terminal se o token pode segui-lo
+                // (FOLLOW) ou fecha uma construção aceita mais abaixo na pilha;
+                // senão descarta o token e tenta de novo
+                if (col != -1 && (((t->follow_set[row] >> col) & 1) || (is_sync_token(col) && stack_accepts(p, col)))) {
+                    log_recovery(p, "removido da pilha ", t->nonterminal_names[row]);
+                    p->top--;
+                } else {
+                    log_recovery(p, "descartado ", col != -1 ? terminals[col] : "token inválido");
+                    inputIndex++;
+                }
+                continue;
+            }
+            if (current_input == end_marker && col != T_END) {
+                // O lookahead é o início do trecho seguinte, que é analisado à parte
+                return finish(p, PARSE_ACCEPTED);
+            }
+
+            if (use_chains) {
+                const Chain *chain = &t->chains[t->chain_table[row * MAX_TERMINALS + col]];
+                if (verbosity >= TRACE_PRODUCTIONS) {
+                    for (int k = 0; k < chain->steps; k++) {
+                        log_production(out, t, &t->productions[t->chain_productions[chain->productions + k]]);
+                    }
+                }
+                p->top--;
+                if (reserve_stack(p, chain->length) != 0) {
+                    return finish(p, PARSE_OUT_OF_MEMORY);
+                }
+                memcpy(&p->stack[p->top + 1], &t->chain_symbols[chain->symbols], chain->length);
+                p->top += chain->length;
+                STATS(for (int k = 0; k < chain->steps; k++) {
+                    count_production(&p->stats, t, t->chain_productions[chain->productions + k], col);
+                });
+                STATS(count_depth(&p->stats, p->top));
+                STATS(p->stats.matches += chain->matches);
+                if (chain->matches) {
+                    if (verbosity >= TRACE_MATCHES) {
+                        writer_puts(out, "Match: ");
+                        writer_puts(out, terminals[col]);
+                        writer_putc(out, '\n');
+                    }
+                    inputIndex++;
+                }
+                continue;
+            }
+
+            const Production *production = &t->productions[table[row * MAX_TERMINALS + col]];
+            if (verbosity >= TRACE_PRODUCTIONS) {
+                log_production(out, t, production);
+            }
+            STATS(count_production(&p->stats, t, table[row * MAX_TERMINALS + col], col));
+            uint32_t first = 0;
+            if (build_tree) {
+                if (reserve_nodes(p, production->length) != 0) {
+                    return finish(p, PARSE_OUT_OF_MEMORY);
+                }
+                // Cada nó é escrito uma única vez: aqui, ao ser expandido, ou no match
+                first = p->tree.count;
+                p->nodes[p->node_stack[p->top]] =
+                    (TreeNode){production->length > 0 ? first : TREE_NONE, (uint32_t)inputIndex, (symbol_t)top_symbol,
+                               production->length, table[row * MAX_TERMINALS + col]};
+                p->tree.count += production->length;
+            }
+            p->top--;
+
+            if (production->length > 0) {
+                // Símbolos já estão em ordem inversa; o filho j é o símbolo length - 1 - j
+                const symbol_t *symbols = &t->prod_symbols[production->offset];
+                for (int i = 0; i < production->length; i++) {
+                    uint32_t child = first + (uint32_t)(production->length - 1 - i);
+                    if (push(p, symbols[i], child, build_tree) != 0) {
+                        return finish(p, PARSE_OUT_OF_MEMORY);
+                    }
+                }
+                STATS(count_depth(&p->stats, p->top));
+                if (verbosity >= TRACE_FULL) log_pilha(p);
+            } else {
+                // Produção vazia (ε)
+                continue;
+            }
+        }
+        if (verbosity >= TRACE_FULL) {
+            writer_puts(out, "INPUT: ");
+            for (size_t i = inputIndex; i < inputCount; i++) {
+                write_token(out, src, &inputTokens[i]);
+                if (i < inputCount - 1) writer_putc(out, ' ');
+            }
+            writer_putc(out, '\n');
         }
     }
+}
 
-    // NUMEXPR' ::= + TERM NUMEXPR' | - TERM NUMEXPR' | ''
-    r = getNonTerminalIndex("NUMEXPRP");
-    {
-        // NUMEXPR' ::= + TERM NUMEXPR'
-        c = getTerminalIndex("+");
-        if (c >= 0)
-            table[r][c] = "+ TERM NUMEXPRP";
-
-        // NUMEXPR' ::= - TERM NUMEXPR'
-        c = getTerminalIndex("-");
-        if (c >= 0)
-            table[r][c] = "- TERM NUMEXPRP";
-
-        // NUMEXPR' ::= ''
-        // FOLLOW(NUMEXPRP) = {"<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ",", "$"}
-        const char *numexprp_follow[] = {"<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ",", "$"};
-        int n_numexprp_follow = sizeof(numexprp_follow) / sizeof(numexprp_follow[0]);
-        for (int i = 0; i < n_numexprp_follow; i++)
-        {
-            c = getTerminalIndex(numexprp_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
-        }
+#if defined(PARSER_DIRECT) && !defined(PARSER_STATS)
+// Mesma análise pelo motor gerado; só o veredito e o primeiro erro
+static ParseStatus run_direct(Parser *p, const char *src, const Token *inputTokens, size_t begin, size_t inputCount,
+                              int start, const Token *end_marker) {
+    begin_parse(p, src);
+    p->stack = NULL;
+    p->stack_capacity = 0;
+    p->top = -1;
+    memset(&p->tree, 0, sizeof(p->tree));
+
+    DirectError error;
+    ParseStatus status = direct_parse(inputTokens, begin, inputCount, start, end_marker, &p->direct, &error);
+    if (status == PARSE_SYNTAX_ERROR) {
+        const Token *current = (error.index < inputCount) ? &inputTokens[error.index] : end_marker;
+        status = syntax_error(p, current, error.index, error.expected, error.nonterminal);
     }
+    return finish(p, status);
+}
+#endif
 
-    // TERM ::= FACTOR TERMP
-    r = getNonTerminalIndex("TERM");
-    {
-        const char *term_first[] = {"id", "num", "("};
-        int nt = sizeof(term_first) / sizeof(term_first[0]);
-        for (int i = 0; i < nt; i++)
-        {
-            c = getTerminalIndex(term_first[i]);
-            if (c >= 0)
-                table[r][c] = "FACTOR TERMP";
+static ParseStatus dispatch(Parser *p, const char *src, const Token *inputTokens, size_t begin, size_t inputCount,
+                            int start, const Token *end_marker) {
+#if defined(PARSER_DIRECT) && !defined(PARSER_STATS)
+    if (!p->build_tree && !p->recovery && p->verbosity < TRACE_PRODUCTIONS && p->tables == &builtin_tables) {
+        return run_direct(p, src, inputTokens, begin, inputCount, start, end_marker);
+    }
+#endif
+    const ParseTables *t = p->tables;
+    if (p->build_tree) {
+        return run_loop(p, t, src, inputTokens, begin, inputCount, start, end_marker, 1, 0);
+    }
+    if (p->chains && p->verbosity < TRACE_FULL) {
+        if (t == &builtin_tables) {
+            return run_loop(p, &builtin_tables, src, inputTokens, begin, inputCount, start, end_marker, 0, 1);
         }
+        return run_loop(p, t, src, inputTokens, begin, inputCount, start, end_marker, 0, 1);
     }
+    return run_loop(p, t, src, inputTokens, begin, inputCount, start, end_marker, 0, 0);
+}
 
-    // TERMP ::= * FACTOR TERMP | / FACTOR TERMP | ''
-    r = getNonTerminalIndex("TERMP");
-    {
-        // TERMP ::= * FACTOR TERMP
-        c = getTerminalIndex("*");
-        if (c >= 0)
-            table[r][c] = "* FACTOR TERMP";
-
-        // TERMP ::= / FACTOR TERMP
-        c = getTerminalIndex("/");
-        if (c >= 0)
-            table[r][c] = "/ FACTOR TERMP";
-
-        // TERMP ::= ''
-        // FOLLOW(TERMP) = {"+", "-", "<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ",", "$"}
-        const char *termp_follow[] = {"+", "-", "<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ",", "$"};
-        int n_termp_follow = sizeof(termp_follow) / sizeof(termp_follow[0]);
-        for (int i = 0; i < n_termp_follow; i++)
-        {
-            c = getTerminalIndex(termp_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
+static ParseStatus run(Parser *p, const char *src, const Token *inputTokens, size_t begin, size_t inputCount,
+                       int start, const Token *end_marker) {
+#ifdef PARSER_STATS
+    double t0 = stats_clock();
+    ParseStatus status = dispatch(p, src, inputTokens, begin, inputCount, start, end_marker);
+    p->stats.parse_seconds += stats_clock() - t0;
+    p->stats.parses++;
+    p->stats.tokens += inputCount - begin;
+    return status;
+#else
+    return dispatch(p, src, inputTokens, begin, inputCount, start, end_marker);
+#endif
+}
+
+// Imprime a árvore em pré-ordem, um nó por linha, indentado pela profundidade.
+// Terminais id e num mostram o lexema; não-terminais vazios mostram ε.
+int parse_tree_print(const ParseTree *tree, const char *src, const TokenArray *tokens, FILE *fp)
+{
+    if (tree->count == 0) {
+        return 0;
+    }
+    const ParseTables *tables = tree->tables != NULL ? tree->tables : &builtin_tables;
+    // Pilha explícita: listas longas (FLISTP, STMTLISTP) são recursivas à direita
+    size_t capacity = 256, top = 0;
+    uint32_t *stack = counted_malloc(capacity * 2 * sizeof(uint32_t));
+    if (stack == NULL) {
+        return -1;
+    }
+    stack[0] = 0;
+    stack[1] = 0;
+    top = 1;
+    while (top > 0) {
+        top--;
+        uint32_t index = stack[2 * top], depth = stack[2 * top + 1];
+        const TreeNode *node = &tree->nodes[index];
+        fprintf(fp, "%*s%s", (int)(2 * depth), "", tables_symbol_name(tables, node->symbol));
+        if (!IS_NONTERMINAL(node->symbol)) {
+            const Token *tk = &tokens->tokens[node->token_begin];
+            if (node->symbol == T_ID || node->symbol == T_NUM) {
+                fprintf(fp, " %.*s", (int)tk->length, src + tk->offset);
+            }
+        } else if (node->num_children == 0) {
+            fprintf(fp, " ε");
+        }
+        fputc('\n', fp);
+
+        if (top + node->num_children > capacity) {
+            capacity = (top + node->num_children) * 2;
+            uint32_t *bigger = counted_realloc(stack, capacity * 2 * sizeof(uint32_t));
+            if (bigger == NULL) {
+                free(stack);
+                return -1;
+            }
+            stack = bigger;
+        }
+        for (uint32_t k = node->num_children; k-- > 0;) {
+            stack[2 * top] = node->first_child + k;
+            stack[2 * top + 1] = depth + 1;
+            top++;
         }
     }
+    free(stack);
+    return 0;
+}
 
-    // FACTOR ::= num | ( NUMEXPR ) | id FACTOR'
-    r = getNonTerminalIndex("FACTOR");
-    {
-        // FACTOR ::= num
-        c = getTerminalIndex("num");
-        if (c >= 0)
-            table[r][c] = "num";
+// Analisa tokens já produzidos pelo lexer
+ParseStatus parser_parse_tokens(Parser *p, const char *src, const TokenArray *tokens)
+{
+    return run(p, src, tokens->tokens, 0, tokens->count, N_S, NULL);
+}
+
+// Analisa tokens[begin, end) a partir do não-terminal start, com next como o
+// lookahead depois do trecho: tokens[end] se next for NULL, ou um '$' virtual
+// se o vetor acaba em end. Com o 'def' da função seguinte, o trecho é aceito
+// quando a análise chega a ele, e um erro no fim do trecho é diagnosticado
+// como na análise do vetor inteiro. Os índices em parser_result continuam
+// relativos ao vetor inteiro. Contextos diferentes podem analisar trechos do
+// mesmo vetor ao mesmo tempo.
+ParseStatus parser_parse_range(Parser *p, const char *src, const TokenArray *tokens, size_t begin, size_t end,
+                               int start, const Token *next)
+{
+    Token end_marker = {0, 0, T_END};
+    if (next != NULL) {
+        end_marker = *next;
+    } else if (end < tokens->count) {
+        end_marker = tokens->tokens[end];
+    } else if (end > 0) {
+        end_marker.offset = tokens->tokens[end - 1].offset + tokens->tokens[end - 1].length;
+    }
+    return run(p, src, tokens->tokens, begin, end, start, &end_marker);
+}
 
-        // FACTOR ::= ( NUMEXPR )
-        c = getTerminalIndex("(");
-        if (c >= 0)
-            table[r][c] = "( NUMEXPR )";
+// Executa lexer e parser sobre o buffer; os tokens ficam no contexto para reuso
+ParseStatus parser_parse_buffer(Parser *p, const char *src, size_t len)
+{
+    if (len > UINT32_MAX) {
+        memset(&p->result, 0, sizeof(p->result));
+        return finish(p, PARSE_INPUT_TOO_LARGE);
+    }
+    STATS(double t0 = stats_clock());
+    if (tokenize_input(src, len, &p->tokens) != 0) {
+        memset(&p->result, 0, sizeof(p->result));
+        return finish(p, PARSE_OUT_OF_MEMORY);
+    }
+    STATS(p->stats.lexer_seconds += stats_clock() - t0);
+    return run(p, src, p->tokens.tokens, 0, p->tokens.count, N_S, NULL);
+}
 
-        // FACTOR ::= id FACTOR'
-        c = getTerminalIndex("id");
-        if (c >= 0)
-            table[r][c] = "id FACTORP";
+// Começa uma análise em fluxo: os tokens chegam um de cada vez por
+// parser_feed, e a pilha é a única estrutura que cresce com a entrada
+ParseStatus parser_feed_begin(Parser *p)
+{
+    begin_parse(p, NULL);
+    p->fed = 0;
+    p->stack_capacity = STACK_INITIAL_CAPACITY;
+    p->stack = arena_alloc(&p->arena, p->stack_capacity * sizeof(symbol_t));
+    p->top = -1;
+    memset(&p->tree, 0, sizeof(p->tree));
+    if (p->stack == NULL) {
+        return PARSE_OUT_OF_MEMORY;
     }
+    push(p, T_END, TREE_NONE, 0);
+    push(p, SYM_NONTERMINAL(N_S), 0, 0);
+    STATS(count_depth(&p->stats, p->top));
+    if (p->verbosity >= TRACE_PRODUCTIONS) writer_puts(&p->out, "Iniciando parsing...\n\n");
+    return PARSE_ACCEPTED;
+}
 
-    // FACTOR' ::= '' | ( PARLISTCALL )
-    r = getNonTerminalIndex("FACTORP");
-    {
-        // FACTOR' ::= ( PARLISTCALL )
-        c = getTerminalIndex("(");
-        if (c >= 0)
-            table[r][c] = "( PARLISTCALL )";
-
-        // FACTOR' ::= ''
-        // FOLLOW(FACTOR') = {"+", "-", "*", "/", "<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ","}
-        const char *factorp_follow[] = {"+", "-", "*", "/", "<", "<=", ">", ">=", "==", "<>", ";", ")", "}", ","};
-        int n_factorp_follow = sizeof(factorp_follow) / sizeof(factorp_follow[0]);
-        for (int i = 0; i < n_factorp_follow; i++)
-        {
-            c = getTerminalIndex(factorp_follow[i]);
-            if (c >= 0 && table[r][c] == NULL)
-                table[r][c] = "";
+// Expande o topo da pilha até casar tk (o mesmo laço de run_loop, sem árvore,
+// recuperação nem trace completo). Retorna 0 se o token foi consumido ou 1 se
+// a análise terminou, com o status em *status; tk == NULL é o fim da entrada.
+// src + tk->offset é o lexema, usado só durante a chamada.
+int parser_feed(Parser *p, const char *src, const Token *tk, ParseStatus *status)
+{
+    const ParseTables *t = p->tables;
+    const uint8_t *table = t->prod_table;
+    Writer *out = &p->out;
+    p->src = src;
+
+    while (1) {
+        int top_symbol = peek(p);
+        if (top_symbol == -1) {
+            *status = PARSE_EMPTY_STACK;
+            return 1;
+        }
+        if (top_symbol == T_END) {
+            if (tk != NULL && tk->type == T_END) {
+                p->top--;
+                p->fed++;
+                *status = PARSE_ACCEPTED;
+            } else {
+                *status = PARSE_NO_END_MARKER;
+            }
+            return 1;
+        }
+
+        if (!IS_NONTERMINAL(top_symbol)) {
+            if (tk == NULL || tk->type != top_symbol) {
+                *status = syntax_error(p, tk, p->fed, top_symbol, -1);
+                return 1;
+            }
+            if (p->verbosity >= TRACE_MATCHES) {
+                writer_puts(out, "Match: ");
+                writer_puts(out, terminals[top_symbol]);
+                writer_putc(out, '\n');
+            }
+            p->top--;
+            STATS(p->stats.matches++);
+            p->fed++;
+            return 0;
+        }
+
+        int row = top_symbol - MAX_TERMINALS;
+        int col = (tk != NULL && tk->type != T_INVALID) ? tk->type : -1;
+        if (col == -1 || table[row * MAX_TERMINALS + col] == NO_PRODUCTION) {
+            *status = syntax_error(p, tk, p->fed, -1, row);
+            return 1;
         }
+
+        if (p->chains) {
+            const Chain *chain = &t->chains[t->chain_table[row * MAX_TERMINALS + col]];
+            if (p->verbosity >= TRACE_PRODUCTIONS) {
+                for (int k = 0; k < chain->steps; k++) {
+                    log_production(out, t, &t->productions[t->chain_productions[chain->productions + k]]);
+                }
+            }
+            p->top--;
+            if (reserve_stack(p, chain->length) != 0) {
+                *status = PARSE_OUT_OF_MEMORY;
+                return 1;
+            }
+            memcpy(&p->stack[p->top + 1], &t->chain_symbols[chain->symbols], chain->length);
+            p->top += chain->length;
+            STATS(for (int k = 0; k < chain->steps; k++) {
+                count_production(&p->stats, t, t->chain_productions[chain->productions + k], col);
+            });
+            STATS(count_depth(&p->stats, p->top));
+            STATS(p->stats.matches += chain->matches);
+            if (chain->matches) {
+                if (p->verbosity >= TRACE_MATCHES) {
+                    writer_puts(out, "Match: ");
+                    writer_puts(out, terminals[col]);
+                    writer_putc(out, '\n');
+                }
+                p->fed++;
+                return 0;
+            }
+            continue;
+        }
+
+        const Production *production = &t->productions[table[row * MAX_TERMINALS + col]];
+        if (p->verbosity >= TRACE_PRODUCTIONS) {
+            log_production(out, t, production);
+        }
+        STATS(count_production(&p->stats, t, table[row * MAX_TERMINALS + col], col));
+        p->top--;
+        if (reserve_stack(p, production->length) != 0) {
+            *status = PARSE_OUT_OF_MEMORY;
+            return 1;
+        }
+        memcpy(&p->stack[p->top + 1], &t->prod_symbols[production->offset], production->length);
+        p->top += production->length;
+        STATS(count_depth(&p->stats, p->top));
     }
+}
 
-    // PARLISTCALL ::= id PARLISTCALLP | ''
-    r = getNonTerminalIndex("PARLISTCALL");
-    {
-        // PARLISTCALL ::= id PARLISTCALLP
-        const char *parlistcall_id_first[] = {"id"};
-        int ni = sizeof(parlistcall_id_first) / sizeof(parlistcall_id_first[0]);
-        for (int i = 0; i < ni; i++)
-        {
-            c = getTerminalIndex(parlistcall_id_first[i]);
-            if (c >= 0)
-                table[r][c] = "id PARLISTCALLP";
+// Encerra a análise em fluxo com o status final (o de parser_feed ou, se a
+// entrada terminou antes, PARSE_NO_END_MARKER): imprime o veredito e esvazia o trace
+ParseStatus parser_feed_end(Parser *p, ParseStatus status)
+{
+    STATS(p->stats.parses++);
+    STATS(p->stats.tokens += p->fed);
+    p->src = NULL; // o lexema do último token já não é válido
+    return finish(p, status);
+}
+
+const ParserStats *parser_stats(const Parser *p)
+{
+    return &p->stats;
+}
+
+// Soma os contadores de s em total (ex.: os contextos das threads de um lote)
+void parser_stats_add(ParserStats *total, const ParserStats *s)
+{
+    total->enabled |= s->enabled;
+    total->parses += s->parses;
+    total->tokens += s->tokens;
+    for (int i = 0; i < MAX_NONTERMINALS; i++) {
+        for (int j = 0; j < MAX_TERMINALS; j++) {
+            total->cells[i][j] += s->cells[i][j];
         }
+    }
+    total->productions += s->productions;
+    total->epsilon += s->epsilon;
+    total->matches += s->matches;
+    total->max_depth = s->max_depth > total->max_depth ? s->max_depth : total->max_depth;
+    total->lexer_seconds += s->lexer_seconds;
+    total->parse_seconds += s->parse_seconds;
+}
+
+typedef struct
+{
+    uint64_t count;
+    uint8_t row;
+    uint8_t col;
+} StatsCell;
 
-        // PARLISTCALL ::= ''
-        // FOLLOW(PARLISTCALL) = {")"}
-        c = getTerminalIndex(")");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+static int compare_cells(const void *a, const void *b)
+{
+    const StatsCell *x = a, *y = b;
+    if (x->count != y->count) {
+        return x->count > y->count ? -1 : 1;
     }
+    return (x->row != y->row) ? x->row - y->row : x->col - y->col;
+}
 
-    // PARLISTCALLP ::= , id PARLISTCALLP | ''
-    r = getNonTerminalIndex("PARLISTCALLP");
-    {
-        // PARLISTCALLP ::= , id PARLISTCALLP
-        const char *parlistcallp_comma_first[] = {","};
-        int nc = sizeof(parlistcallp_comma_first) / sizeof(parlistcallp_comma_first[0]);
-        for (int i = 0; i < nc; i++)
-        {
-            c = getTerminalIndex(parlistcallp_comma_first[i]);
-            if (c >= 0)
-                table[r][c] = ", id PARLISTCALLP";
+// JSON com os totais e as células usadas, da mais aplicada para a menos
+int parser_stats_write_json(const ParserStats *s, FILE *fp)
+{
+    StatsCell cells[MAX_NONTERMINALS * MAX_TERMINALS];
+    size_t n = 0;
+    for (int i = 0; i < MAX_NONTERMINALS; i++) {
+        for (int j = 0; j < MAX_TERMINALS; j++) {
+            if (s->cells[i][j] > 0) {
+                cells[n++] = (StatsCell){s->cells[i][j], (uint8_t)i, (uint8_t)j};
+            }
         }
+    }
+    qsort(cells, n, sizeof(StatsCell), compare_cells);
+
+    fprintf(fp, "{\n  \"enabled\": %s,\n  \"parses\": %" PRIu64 ",\n  \"tokens\": %" PRIu64 ",\n",
+            s->enabled ? "true" : "false", s->parses, s->tokens);
+    fprintf(fp, "  \"productions\": %" PRIu64 ",\n  \"epsilon\": %" PRIu64 ",\n  \"matches\": %" PRIu64 ",\n",
+            s->productions, s->epsilon, s->matches);
+    fprintf(fp, "  \"max_stack_depth\": %" PRIu64 ",\n  \"lexer_seconds\": %.9f,\n  \"parse_seconds\": %.9f,\n",
+            s->max_depth, s->lexer_seconds, s->parse_seconds);
+    fprintf(fp, "  \"cells\": [");
+    for (size_t i = 0; i < n; i++) {
+        const Production *production = &productions[prod_table[cells[i].row][cells[i].col]];
+        fprintf(fp, "%s\n    {\"nonterminal\": \"%s\", \"lookahead\": \"%s\", \"production\": \"%s -> %s\", "
+                "\"count\": %" PRIu64 "}",
+                i ? "," : "", nonTerminals[cells[i].row], terminals[cells[i].col], nonTerminals[cells[i].row],
+                production->length > 0 ? production->text : "ε", cells[i].count);
+    }
+    fprintf(fp, "%s]\n}\n", n ? "\n  " : "");
+    return ferror(fp) ? -1 : 0;
+}
 
-        // PARLISTCALLP ::= ''
-        // FOLLOW(PARLISTCALLP) = {")"}
-        c = getTerminalIndex(")");
-        if (c >= 0 && table[r][c] == NULL)
-            table[r][c] = "";
+int parser_stats_save(const ParserStats *s, const char *path)
+{
+    if (strcmp(path, "-") == 0) {
+        return parser_stats_write_json(s, stdout);
+    }
+    FILE *fp = fopen(path, "w");
+    if (fp == NULL) {
+        return -1;
     }
-}
\ No newline at end of file
+    int status = parser_stats_write_json(s, fp);
+    return (fclose(fp) == 0 && status == 0) ? 0 : -1;
+}
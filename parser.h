@@ -4,21 +4,220 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 
 #define MAX_NONTERMINALS 28
 #define MAX_TERMINALS 27
-#define MAX_STACK 500
-#define MAX_INPUT 8192
 
-extern const char* nonTerminals[];
-extern const char* terminals[];
-extern int num_non_terminals;
-extern int num_terminals;
-extern const char* table[MAX_NONTERMINALS][MAX_TERMINALS];
+// Índices dos terminais em terminals[]
+enum
+{
+    T_DEF, T_INT, T_ID, T_NUM, T_IF, T_ELSE, T_RETURN, T_PRINT,
+    T_LBRACE, T_RBRACE, T_LPAREN, T_RPAREN, T_COMMA, T_SEMICOLON, T_ASSIGN,
+    T_LT, T_LE, T_GT, T_GE, T_EQ, T_NE, T_EQEQ, T_PLUS, T_MINUS, T_STAR, T_SLASH,
+    T_END
+};
+
+// Tipo usado para lexemas que não correspondem a nenhum terminal (ex.: '&')
+#define T_INVALID 255
+
+// Índices dos não-terminais em nonTerminals[]
+enum
+{
+    N_S, N_MAIN, N_FLIST, N_FLISTP, N_FDEF,
+    N_PARLIST, N_PARLISTP, N_VARLIST, N_VARLISTP,
+    N_STMT, N_ATRIBST, N_PRINTST, N_RETURNST,
+    N_RETURNSTP, N_IFSTMT, N_IFSTMTTAIL,
+    N_STMTLIST, N_STMTLISTP,
+    N_EXPR, N_EXPRP,
+    N_NUMEXPR, N_NUMEXPRP,
+    N_TERM, N_TERMP,
+    N_FACTOR, N_FACTORP,
+    N_PARLISTCALL, N_PARLISTCALLP
+};
+
+// Símbolos da gramática: terminais em [0, MAX_TERMINALS), não-terminais logo em seguida
+typedef uint8_t symbol_t;
+#define SYM_NONTERMINAL(n) ((symbol_t)(MAX_TERMINALS + (n)))
+#define IS_NONTERMINAL(s) ((s) >= MAX_TERMINALS)
+
+#define MAX_PRODUCTIONS 64
+#define NO_PRODUCTION 0xFF
+
+// Produção compilada: símbolos em prod_symbols[offset .. offset + length), em ordem inversa
+typedef struct
+{
+    uint16_t offset;
+    uint8_t length;
+    uint8_t lhs;
+    const char *text;
+} Production;
+
+// Cadeia de expansões pré-computada para uma célula da tabela: aplica as
+// produções chain_productions[productions .. productions + steps) de uma vez,
+// empilhando chain_symbols[symbols .. symbols + length) (em ordem inversa), e
+// consome o lookahead se matches
+typedef struct
+{
+    uint16_t symbols;
+    uint8_t length;
+    uint16_t productions;
+    uint8_t steps;
+    uint8_t matches;
+} Chain;
+
+// Tabela LL(1) gerada em tempo de compilação (table_gen.c, a partir de grammar.txt)
+extern const uint32_t grammar_version;
+extern const char *const nonTerminals[MAX_NONTERMINALS];
+extern const char *const terminals[MAX_TERMINALS];
+extern const Production productions[MAX_PRODUCTIONS];
+extern const symbol_t prod_symbols[];
+extern const int num_productions;
+extern const uint8_t prod_table[MAX_NONTERMINALS][MAX_TERMINALS];
+extern const uint32_t follow_set[MAX_NONTERMINALS];
+extern const uint16_t chain_table[MAX_NONTERMINALS][MAX_TERMINALS];
+extern const Chain chains[];
+extern const symbol_t chain_symbols[];
+extern const uint8_t chain_productions[];
+
+// Tabelas usadas por um contexto: as compiladas no binário (builtin_tables,
+// de table_gen.c) ou as de uma gramática carregada em tempo de execução
+// (tables.h). As colunas são sempre os MAX_TERMINALS terminais do lexer.
+typedef struct
+{
+    int num_nonterminals;
+    int num_productions;
+    const char *const *nonterminal_names;
+    const Production *productions;
+    const symbol_t *prod_symbols;
+    const uint8_t *prod_table;   // [num_nonterminals * MAX_TERMINALS]
+    const uint32_t *follow_set;
+    const uint16_t *chain_table; // [num_nonterminals * MAX_TERMINALS]
+    const Chain *chains;
+    const symbol_t *chain_symbols;
+    const uint8_t *chain_productions;
+} ParseTables;
+
+extern const ParseTables builtin_tables;
 
 int getNonTerminalIndex(const char* symbol);
 int getTerminalIndex(const char* symbol);
-int tokenize_production(const char *production, char tokens[][MAX_INPUT], int max_tokens);
-void initialize_table();
+int terminal_lookup(const char *s, size_t len);
+int nonterminal_lookup(const char *s, size_t len);
+const char *symbol_name(symbol_t symbol);
+
+typedef struct Token Token;
+typedef struct TokenArray TokenArray;
+
+// Níveis de saída do analisador
+enum
+{
+    TRACE_NONE = -1,   // nenhuma saída (padrão da API)
+    TRACE_QUIET,       // só o veredito ou o primeiro diagnóstico
+    TRACE_PRODUCTIONS, // + produções aplicadas
+    TRACE_MATCHES,     // + terminais reconhecidos
+    TRACE_FULL         // + pilha e entrada restante a cada passo
+};
+
+typedef enum
+{
+    PARSE_ACCEPTED = 0,
+    PARSE_SYNTAX_ERROR,
+    PARSE_NO_END_MARKER,
+    PARSE_EMPTY_STACK,
+    PARSE_INPUT_TOO_LARGE,
+    PARSE_OUT_OF_MEMORY
+} ParseStatus;
+
+// Resultado estruturado da última análise
+typedef struct
+{
+    ParseStatus status;
+    size_t token_index; // token em que o erro foi detectado
+    int has_token;      // 0 se o erro ocorreu no fim da entrada
+    int token_type;
+    uint32_t offset;    // posição do lexema no fonte
+    uint32_t length;
+    int expected;       // terminal esperado, ou -1
+    int nonterminal;    // não-terminal sem produção para o lookahead, ou -1
+} ParseResult;
+
+// Contadores do laço do parser, acumulados entre as análises de um contexto.
+// Só são coletados com -DPARSER_STATS (sem a flag o laço não tem nenhuma
+// instrução a mais e enabled fica 0); com ela, o motor direto não é usado.
+// As células só são contadas com a gramática compilada no binário.
+typedef struct
+{
+    int enabled;
+    uint64_t parses;
+    uint64_t tokens;
+    uint64_t cells[MAX_NONTERMINALS][MAX_TERMINALS]; // produções aplicadas por célula (não-terminal, lookahead)
+    uint64_t productions;                            // total de produções aplicadas
+    uint64_t epsilon;                                // das quais vazias (ε)
+    uint64_t matches;                                // terminais reconhecidos
+    uint64_t max_depth;                              // maior profundidade da pilha
+    double lexer_seconds;
+    double parse_seconds;
+} ParserStats;
+
+// Nó da árvore sintática (12 bytes). Os filhos de um nó são consecutivos:
+// nodes[first_child .. first_child + num_children), da esquerda para a direita;
+// o irmão seguinte de um filho é o índice seguinte. A raiz é nodes[0]. O nó
+// deriva os tokens [token_begin, parse_tree_token_end(...)).
+#define TREE_NONE UINT32_MAX
+
+typedef struct
+{
+    uint32_t first_child; // ou TREE_NONE
+    uint32_t token_begin;
+    symbol_t symbol;
+    uint8_t num_children;
+    uint8_t production;   // produção aplicada (não-terminais) ou NO_PRODUCTION
+} TreeNode;
+
+typedef struct
+{
+    const TreeNode *nodes;
+    uint32_t count;
+    const ParseTables *tables; // gramática dos símbolos e produções dos nós
+} ParseTree;
+
+// Contexto reentrante: um por thread (ou por análise simultânea)
+typedef struct Parser Parser;
+
+Parser *parser_create(void);
+void parser_set_verbosity(Parser *p, int verbosity);
+void parser_set_output(Parser *p, FILE *fp);
+void parser_set_build_tree(Parser *p, int enabled);
+void parser_set_recovery(Parser *p, int enabled);
+void parser_set_chains(Parser *p, int enabled);
+void parser_set_tables(Parser *p, const ParseTables *tables);
+ParseStatus parser_parse_buffer(Parser *p, const char *src, size_t len);
+ParseStatus parser_parse_tokens(Parser *p, const char *src, const TokenArray *tokens);
+ParseStatus parser_parse_range(Parser *p, const char *src, const TokenArray *tokens, size_t begin, size_t end,
+                               int start, const Token *next);
+const ParseResult *parser_result(const Parser *p);
+const ParseTree *parser_tree(const Parser *p);
+const ParseResult *parser_errors(const Parser *p, size_t *count);
+uint32_t parse_tree_token_end(const ParseTree *tree, uint32_t index);
+int parse_tree_print(const ParseTree *tree, const char *src, const TokenArray *tokens, FILE *fp);
+size_t parser_token_count(const Parser *p);
+const TokenArray *parser_tokens(const Parser *p);
+int parser_message(const Parser *p, char *buf, size_t size);
+int parse_result_message(const ParseResult *r, const char *src, char *buf, size_t size);
+const ParserStats *parser_stats(const Parser *p);
+void parser_stats_add(ParserStats *total, const ParserStats *s);
+int parser_stats_write_json(const ParserStats *s, FILE *fp);
+int parser_stats_save(const ParserStats *s, const char *path); // "-" é a saída padrão
+
+// Análise em fluxo (stream.h): o chamador entrega um token de cada vez.
+// parser_feed retorna 1 quando a análise termina (status em *status); o
+// veredito só é impresso em parser_feed_end, que recebe o status final.
+ParseStatus parser_feed_begin(Parser *p);
+int parser_feed(Parser *p, const char *src, const Token *tk, ParseStatus *status);
+ParseStatus parser_feed_end(Parser *p, ParseStatus status);
+
+void parser_reset(Parser *p);
+void parser_destroy(Parser *p);
 
 #endif
\ No newline at end of file
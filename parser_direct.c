@@ -0,0 +1,1063 @@
+// Gerado por gen_table --direct a partir de grammar.txt (versão 0xa51c1834). Não editar.
+#include "parser_direct.h"
+#include "arena.h"
+
+_Static_assert(MAX_TERMINALS == 27, "grammar.txt e parser.h divergem");
+_Static_assert(MAX_NONTERMINALS == 28, "grammar.txt e parser.h divergem");
+
+// Maior número de símbolos empilhados num passo
+#define DIRECT_MAX_PUSH 8
+
+static const uint64_t selects[28] = {
+    /* S            */ 0x00000000040021d7ull,
+    /* MAIN         */ 0x00000000040021d7ull,
+    /* FLIST        */ 0x0000000000000001ull,
+    /* FLISTP       */ 0x0000000004000001ull,
+    /* FDEF         */ 0x0000000000000001ull,
+    /* PARLIST      */ 0x0000000000000802ull,
+    /* PARLISTP     */ 0x0000000000001800ull,
+    /* VARLIST      */ 0x0000000000000004ull,
+    /* VARLISTP     */ 0x0000000000003000ull,
+    /* STMT         */ 0x00000000000021d6ull,
+    /* ATRIBST      */ 0x0000000000000004ull,
+    /* PRINTST      */ 0x0000000000000080ull,
+    /* RETURNST     */ 0x0000000000000040ull,
+    /* RETURNSTP    */ 0x0000000000002004ull,
+    /* IFSTMT       */ 0x0000000000000010ull,
+    /* IFSTMTTAIL   */ 0x00000000040023f6ull,
+    /* STMTLIST     */ 0x00000000000021d6ull,
+    /* STMTLISTP    */ 0x00000000000023d6ull,
+    /* EXPR         */ 0x000000000000040cull,
+    /* EXPRP        */ 0x000000000037a800ull,
+    /* NUMEXPR      */ 0x000000000000040cull,
+    /* NUMEXPRP     */ 0x0000000000f7a800ull,
+    /* TERM         */ 0x000000000000040cull,
+    /* TERMP        */ 0x0000000003f7a800ull,
+    /* FACTOR       */ 0x000000000000040cull,
+    /* FACTORP      */ 0x0000000003f7ac00ull,
+    /* PARLISTCALL  */ 0x0000000000000804ull,
+    /* PARLISTCALLP */ 0x0000000000001800ull,
+};
+
+static int grow(DirectStack *stack, size_t needed)
+{
+    size_t capacity = stack->capacity ? stack->capacity : 256;
+    while (capacity < needed)
+    {
+        capacity *= 2;
+    }
+    symbol_t *data = counted_realloc(stack->data, capacity * sizeof(symbol_t));
+    if (data == NULL)
+    {
+        return -1;
+    }
+    stack->data = data;
+    stack->capacity = capacity;
+    return 0;
+}
+
+ParseStatus direct_parse(const Token *tokens, size_t begin, size_t count, int start, const Token *end_marker,
+                         DirectStack *stack, DirectError *error)
+{
+    if (stack->capacity < 256 && grow(stack, 256) != 0)
+    {
+        return PARSE_OUT_OF_MEMORY;
+    }
+    symbol_t *s = stack->data;
+    size_t top = 0;
+    s[top++] = 26; // $
+    s[top++] = (symbol_t)(MAX_TERMINALS + start);
+    size_t i = begin;
+
+    while (1)
+    {
+        if (top + DIRECT_MAX_PUSH > stack->capacity)
+        {
+            if (grow(stack, top + DIRECT_MAX_PUSH) != 0)
+            {
+                return PARSE_OUT_OF_MEMORY;
+            }
+            s = stack->data;
+        }
+        symbol_t x = s[--top];
+        int type = -1;
+        if (i < count)
+        {
+            type = tokens[i].type;
+        }
+        else if (end_marker != NULL)
+        {
+            type = end_marker->type;
+            // O lookahead é o início do trecho seguinte, que é analisado à parte
+            if (type != 26 && type < MAX_TERMINALS && x >= MAX_TERMINALS &&
+                ((selects[x - MAX_TERMINALS] >> type) & 1))
+            {
+                return PARSE_ACCEPTED;
+            }
+        }
+        switch (x)
+        {
+        case 26: // $
+            return type == 26 ? PARSE_ACCEPTED : PARSE_NO_END_MARKER;
+        case 0: // def
+        case 1: // int
+        case 2: // id
+        case 3: // num
+        case 4: // if
+        case 5: // else
+        case 6: // return
+        case 7: // print
+        case 8: // {
+        case 9: // }
+        case 10: // (
+        case 11: // )
+        case 12: // ,
+        case 13: // ;
+        case 14: // :=
+        case 15: // <
+        case 16: // <=
+        case 17: // >
+        case 18: // >=
+        case 19: // =
+        case 20: // <>
+        case 21: // ==
+        case 22: // +
+        case 23: // -
+        case 24: // *
+        case 25: // /
+            if (type != x)
+            {
+                error->expected = x;
+                error->nonterminal = -1;
+                goto syntax_error;
+            }
+            i++;
+            continue;
+        case 27: // S
+            switch (type)
+            {
+            case 0: // def
+                // S -> MAIN > MAIN -> FLIST > FLIST -> FDEF FLISTP > FDEF -> def id ( PARLIST ) { STMTLIST }
+                s[top + 0] = 30; // FLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                s[top + 3] = 8; // {
+                s[top + 4] = 11; // )
+                s[top + 5] = 32; // PARLIST
+                s[top + 6] = 10; // (
+                s[top + 7] = 2; // id
+                top += 8;
+                i++;
+                continue;
+            case 1: // int
+                // S -> MAIN > MAIN -> STMT > STMT -> int VARLIST ;
+                s[top + 0] = 13; // ;
+                s[top + 1] = 34; // VARLIST
+                top += 2;
+                i++;
+                continue;
+            case 2: // id
+                // S -> MAIN > MAIN -> STMT > STMT -> ATRIBST ; > ATRIBST -> id := EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                s[top + 2] = 14; // :=
+                top += 3;
+                i++;
+                continue;
+            case 4: // if
+                // S -> MAIN > MAIN -> STMT > STMT -> IFSTMT > IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 42; // IFSTMTTAIL
+                s[top + 1] = 36; // STMT
+                s[top + 2] = 11; // )
+                s[top + 3] = 45; // EXPR
+                s[top + 4] = 10; // (
+                top += 5;
+                i++;
+                continue;
+            case 6: // return
+                // S -> MAIN > MAIN -> STMT > STMT -> RETURNST ; > RETURNST -> return RETURNSTP
+                s[top + 0] = 13; // ;
+                s[top + 1] = 40; // RETURNSTP
+                top += 2;
+                i++;
+                continue;
+            case 7: // print
+                // S -> MAIN > MAIN -> STMT > STMT -> PRINTST ; > PRINTST -> print EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                top += 2;
+                i++;
+                continue;
+            case 8: // {
+                // S -> MAIN > MAIN -> STMT > STMT -> { STMTLIST }
+                s[top + 0] = 9; // }
+                s[top + 1] = 43; // STMTLIST
+                top += 2;
+                i++;
+                continue;
+            case 13: // ;
+                // S -> MAIN > MAIN -> STMT > STMT -> ;
+                i++;
+                continue;
+            case 26: // $
+                // S -> MAIN > MAIN -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 0;
+            goto syntax_error;
+        case 28: // MAIN
+            switch (type)
+            {
+            case 0: // def
+                // MAIN -> FLIST > FLIST -> FDEF FLISTP > FDEF -> def id ( PARLIST ) { STMTLIST }
+                s[top + 0] = 30; // FLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                s[top + 3] = 8; // {
+                s[top + 4] = 11; // )
+                s[top + 5] = 32; // PARLIST
+                s[top + 6] = 10; // (
+                s[top + 7] = 2; // id
+                top += 8;
+                i++;
+                continue;
+            case 1: // int
+                // MAIN -> STMT > STMT -> int VARLIST ;
+                s[top + 0] = 13; // ;
+                s[top + 1] = 34; // VARLIST
+                top += 2;
+                i++;
+                continue;
+            case 2: // id
+                // MAIN -> STMT > STMT -> ATRIBST ; > ATRIBST -> id := EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                s[top + 2] = 14; // :=
+                top += 3;
+                i++;
+                continue;
+            case 4: // if
+                // MAIN -> STMT > STMT -> IFSTMT > IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 42; // IFSTMTTAIL
+                s[top + 1] = 36; // STMT
+                s[top + 2] = 11; // )
+                s[top + 3] = 45; // EXPR
+                s[top + 4] = 10; // (
+                top += 5;
+                i++;
+                continue;
+            case 6: // return
+                // MAIN -> STMT > STMT -> RETURNST ; > RETURNST -> return RETURNSTP
+                s[top + 0] = 13; // ;
+                s[top + 1] = 40; // RETURNSTP
+                top += 2;
+                i++;
+                continue;
+            case 7: // print
+                // MAIN -> STMT > STMT -> PRINTST ; > PRINTST -> print EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                top += 2;
+                i++;
+                continue;
+            case 8: // {
+                // MAIN -> STMT > STMT -> { STMTLIST }
+                s[top + 0] = 9; // }
+                s[top + 1] = 43; // STMTLIST
+                top += 2;
+                i++;
+                continue;
+            case 13: // ;
+                // MAIN -> STMT > STMT -> ;
+                i++;
+                continue;
+            case 26: // $
+                // MAIN -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 1;
+            goto syntax_error;
+        case 29: // FLIST
+            switch (type)
+            {
+            case 0: // def
+                // FLIST -> FDEF FLISTP > FDEF -> def id ( PARLIST ) { STMTLIST }
+                s[top + 0] = 30; // FLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                s[top + 3] = 8; // {
+                s[top + 4] = 11; // )
+                s[top + 5] = 32; // PARLIST
+                s[top + 6] = 10; // (
+                s[top + 7] = 2; // id
+                top += 8;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 2;
+            goto syntax_error;
+        case 30: // FLISTP
+            switch (type)
+            {
+            case 0: // def
+                // FLISTP -> FDEF FLISTP > FDEF -> def id ( PARLIST ) { STMTLIST }
+                s[top + 0] = 30; // FLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                s[top + 3] = 8; // {
+                s[top + 4] = 11; // )
+                s[top + 5] = 32; // PARLIST
+                s[top + 6] = 10; // (
+                s[top + 7] = 2; // id
+                top += 8;
+                i++;
+                continue;
+            case 26: // $
+                // FLISTP -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 3;
+            goto syntax_error;
+        case 31: // FDEF
+            switch (type)
+            {
+            case 0: // def
+                // FDEF -> def id ( PARLIST ) { STMTLIST }
+                s[top + 0] = 9; // }
+                s[top + 1] = 43; // STMTLIST
+                s[top + 2] = 8; // {
+                s[top + 3] = 11; // )
+                s[top + 4] = 32; // PARLIST
+                s[top + 5] = 10; // (
+                s[top + 6] = 2; // id
+                top += 7;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 4;
+            goto syntax_error;
+        case 32: // PARLIST
+            switch (type)
+            {
+            case 1: // int
+                // PARLIST -> int id PARLISTP
+                s[top + 0] = 33; // PARLISTP
+                s[top + 1] = 2; // id
+                top += 2;
+                i++;
+                continue;
+            case 11: // )
+                // PARLIST -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 5;
+            goto syntax_error;
+        case 33: // PARLISTP
+            switch (type)
+            {
+            case 11: // )
+                // PARLISTP -> ε
+                continue;
+            case 12: // ,
+                // PARLISTP -> , int id PARLISTP
+                s[top + 0] = 33; // PARLISTP
+                s[top + 1] = 2; // id
+                s[top + 2] = 1; // int
+                top += 3;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 6;
+            goto syntax_error;
+        case 34: // VARLIST
+            switch (type)
+            {
+            case 2: // id
+                // VARLIST -> id VARLISTP
+                s[top + 0] = 35; // VARLISTP
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 7;
+            goto syntax_error;
+        case 35: // VARLISTP
+            switch (type)
+            {
+            case 12: // ,
+                // VARLISTP -> , id VARLISTP
+                s[top + 0] = 35; // VARLISTP
+                s[top + 1] = 2; // id
+                top += 2;
+                i++;
+                continue;
+            case 13: // ;
+                // VARLISTP -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 8;
+            goto syntax_error;
+        case 36: // STMT
+            switch (type)
+            {
+            case 1: // int
+                // STMT -> int VARLIST ;
+                s[top + 0] = 13; // ;
+                s[top + 1] = 34; // VARLIST
+                top += 2;
+                i++;
+                continue;
+            case 2: // id
+                // STMT -> ATRIBST ; > ATRIBST -> id := EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                s[top + 2] = 14; // :=
+                top += 3;
+                i++;
+                continue;
+            case 4: // if
+                // STMT -> IFSTMT > IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 42; // IFSTMTTAIL
+                s[top + 1] = 36; // STMT
+                s[top + 2] = 11; // )
+                s[top + 3] = 45; // EXPR
+                s[top + 4] = 10; // (
+                top += 5;
+                i++;
+                continue;
+            case 6: // return
+                // STMT -> RETURNST ; > RETURNST -> return RETURNSTP
+                s[top + 0] = 13; // ;
+                s[top + 1] = 40; // RETURNSTP
+                top += 2;
+                i++;
+                continue;
+            case 7: // print
+                // STMT -> PRINTST ; > PRINTST -> print EXPR
+                s[top + 0] = 13; // ;
+                s[top + 1] = 45; // EXPR
+                top += 2;
+                i++;
+                continue;
+            case 8: // {
+                // STMT -> { STMTLIST }
+                s[top + 0] = 9; // }
+                s[top + 1] = 43; // STMTLIST
+                top += 2;
+                i++;
+                continue;
+            case 13: // ;
+                // STMT -> ;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 9;
+            goto syntax_error;
+        case 37: // ATRIBST
+            switch (type)
+            {
+            case 2: // id
+                // ATRIBST -> id := EXPR
+                s[top + 0] = 45; // EXPR
+                s[top + 1] = 14; // :=
+                top += 2;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 10;
+            goto syntax_error;
+        case 38: // PRINTST
+            switch (type)
+            {
+            case 7: // print
+                // PRINTST -> print EXPR
+                s[top + 0] = 45; // EXPR
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 11;
+            goto syntax_error;
+        case 39: // RETURNST
+            switch (type)
+            {
+            case 6: // return
+                // RETURNST -> return RETURNSTP
+                s[top + 0] = 40; // RETURNSTP
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 12;
+            goto syntax_error;
+        case 40: // RETURNSTP
+            switch (type)
+            {
+            case 2: // id
+                // RETURNSTP -> id
+                i++;
+                continue;
+            case 13: // ;
+                // RETURNSTP -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 13;
+            goto syntax_error;
+        case 41: // IFSTMT
+            switch (type)
+            {
+            case 4: // if
+                // IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 42; // IFSTMTTAIL
+                s[top + 1] = 36; // STMT
+                s[top + 2] = 11; // )
+                s[top + 3] = 45; // EXPR
+                s[top + 4] = 10; // (
+                top += 5;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 14;
+            goto syntax_error;
+        case 42: // IFSTMTTAIL
+            switch (type)
+            {
+            case 1: // int
+                // IFSTMTTAIL -> ε
+                continue;
+            case 2: // id
+                // IFSTMTTAIL -> ε
+                continue;
+            case 4: // if
+                // IFSTMTTAIL -> ε
+                continue;
+            case 5: // else
+                // IFSTMTTAIL -> else STMT
+                s[top + 0] = 36; // STMT
+                top += 1;
+                i++;
+                continue;
+            case 6: // return
+                // IFSTMTTAIL -> ε
+                continue;
+            case 7: // print
+                // IFSTMTTAIL -> ε
+                continue;
+            case 8: // {
+                // IFSTMTTAIL -> ε
+                continue;
+            case 9: // }
+                // IFSTMTTAIL -> ε
+                continue;
+            case 13: // ;
+                // IFSTMTTAIL -> ε
+                continue;
+            case 26: // $
+                // IFSTMTTAIL -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 15;
+            goto syntax_error;
+        case 43: // STMTLIST
+            switch (type)
+            {
+            case 1: // int
+                // STMTLIST -> STMT STMTLISTP > STMT -> int VARLIST ;
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 34; // VARLIST
+                top += 3;
+                i++;
+                continue;
+            case 2: // id
+                // STMTLIST -> STMT STMTLISTP > STMT -> ATRIBST ; > ATRIBST -> id := EXPR
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 45; // EXPR
+                s[top + 3] = 14; // :=
+                top += 4;
+                i++;
+                continue;
+            case 4: // if
+                // STMTLIST -> STMT STMTLISTP > STMT -> IFSTMT > IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 42; // IFSTMTTAIL
+                s[top + 2] = 36; // STMT
+                s[top + 3] = 11; // )
+                s[top + 4] = 45; // EXPR
+                s[top + 5] = 10; // (
+                top += 6;
+                i++;
+                continue;
+            case 6: // return
+                // STMTLIST -> STMT STMTLISTP > STMT -> RETURNST ; > RETURNST -> return RETURNSTP
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 40; // RETURNSTP
+                top += 3;
+                i++;
+                continue;
+            case 7: // print
+                // STMTLIST -> STMT STMTLISTP > STMT -> PRINTST ; > PRINTST -> print EXPR
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 45; // EXPR
+                top += 3;
+                i++;
+                continue;
+            case 8: // {
+                // STMTLIST -> STMT STMTLISTP > STMT -> { STMTLIST }
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                top += 3;
+                i++;
+                continue;
+            case 13: // ;
+                // STMTLIST -> STMT STMTLISTP > STMT -> ;
+                s[top + 0] = 44; // STMTLISTP
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 16;
+            goto syntax_error;
+        case 44: // STMTLISTP
+            switch (type)
+            {
+            case 1: // int
+                // STMTLISTP -> STMT STMTLISTP > STMT -> int VARLIST ;
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 34; // VARLIST
+                top += 3;
+                i++;
+                continue;
+            case 2: // id
+                // STMTLISTP -> STMT STMTLISTP > STMT -> ATRIBST ; > ATRIBST -> id := EXPR
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 45; // EXPR
+                s[top + 3] = 14; // :=
+                top += 4;
+                i++;
+                continue;
+            case 4: // if
+                // STMTLISTP -> STMT STMTLISTP > STMT -> IFSTMT > IFSTMT -> if ( EXPR ) STMT IFSTMTTAIL
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 42; // IFSTMTTAIL
+                s[top + 2] = 36; // STMT
+                s[top + 3] = 11; // )
+                s[top + 4] = 45; // EXPR
+                s[top + 5] = 10; // (
+                top += 6;
+                i++;
+                continue;
+            case 6: // return
+                // STMTLISTP -> STMT STMTLISTP > STMT -> RETURNST ; > RETURNST -> return RETURNSTP
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 40; // RETURNSTP
+                top += 3;
+                i++;
+                continue;
+            case 7: // print
+                // STMTLISTP -> STMT STMTLISTP > STMT -> PRINTST ; > PRINTST -> print EXPR
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 13; // ;
+                s[top + 2] = 45; // EXPR
+                top += 3;
+                i++;
+                continue;
+            case 8: // {
+                // STMTLISTP -> STMT STMTLISTP > STMT -> { STMTLIST }
+                s[top + 0] = 44; // STMTLISTP
+                s[top + 1] = 9; // }
+                s[top + 2] = 43; // STMTLIST
+                top += 3;
+                i++;
+                continue;
+            case 9: // }
+                // STMTLISTP -> ε
+                continue;
+            case 13: // ;
+                // STMTLISTP -> STMT STMTLISTP > STMT -> ;
+                s[top + 0] = 44; // STMTLISTP
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 17;
+            goto syntax_error;
+        case 45: // EXPR
+            switch (type)
+            {
+            case 2: // id
+                // EXPR -> NUMEXPR EXPRP > NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> id FACTORP
+                s[top + 0] = 46; // EXPRP
+                s[top + 1] = 48; // NUMEXPRP
+                s[top + 2] = 50; // TERMP
+                s[top + 3] = 52; // FACTORP
+                top += 4;
+                i++;
+                continue;
+            case 3: // num
+                // EXPR -> NUMEXPR EXPRP > NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> num
+                s[top + 0] = 46; // EXPRP
+                s[top + 1] = 48; // NUMEXPRP
+                s[top + 2] = 50; // TERMP
+                top += 3;
+                i++;
+                continue;
+            case 10: // (
+                // EXPR -> NUMEXPR EXPRP > NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> ( NUMEXPR )
+                s[top + 0] = 46; // EXPRP
+                s[top + 1] = 48; // NUMEXPRP
+                s[top + 2] = 50; // TERMP
+                s[top + 3] = 11; // )
+                s[top + 4] = 47; // NUMEXPR
+                top += 5;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 18;
+            goto syntax_error;
+        case 46: // EXPRP
+            switch (type)
+            {
+            case 11: // )
+                // EXPRP -> ε
+                continue;
+            case 13: // ;
+                // EXPRP -> ε
+                continue;
+            case 15: // <
+                // EXPRP -> < NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            case 16: // <=
+                // EXPRP -> <= NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            case 17: // >
+                // EXPRP -> > NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            case 18: // >=
+                // EXPRP -> >= NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            case 20: // <>
+                // EXPRP -> <> NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            case 21: // ==
+                // EXPRP -> == NUMEXPR
+                s[top + 0] = 47; // NUMEXPR
+                top += 1;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 19;
+            goto syntax_error;
+        case 47: // NUMEXPR
+            switch (type)
+            {
+            case 2: // id
+                // NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> id FACTORP
+                s[top + 0] = 48; // NUMEXPRP
+                s[top + 1] = 50; // TERMP
+                s[top + 2] = 52; // FACTORP
+                top += 3;
+                i++;
+                continue;
+            case 3: // num
+                // NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> num
+                s[top + 0] = 48; // NUMEXPRP
+                s[top + 1] = 50; // TERMP
+                top += 2;
+                i++;
+                continue;
+            case 10: // (
+                // NUMEXPR -> TERM NUMEXPRP > TERM -> FACTOR TERMP > FACTOR -> ( NUMEXPR )
+                s[top + 0] = 48; // NUMEXPRP
+                s[top + 1] = 50; // TERMP
+                s[top + 2] = 11; // )
+                s[top + 3] = 47; // NUMEXPR
+                top += 4;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 20;
+            goto syntax_error;
+        case 48: // NUMEXPRP
+            switch (type)
+            {
+            case 11: // )
+                // NUMEXPRP -> ε
+                continue;
+            case 13: // ;
+                // NUMEXPRP -> ε
+                continue;
+            case 15: // <
+                // NUMEXPRP -> ε
+                continue;
+            case 16: // <=
+                // NUMEXPRP -> ε
+                continue;
+            case 17: // >
+                // NUMEXPRP -> ε
+                continue;
+            case 18: // >=
+                // NUMEXPRP -> ε
+                continue;
+            case 20: // <>
+                // NUMEXPRP -> ε
+                continue;
+            case 21: // ==
+                // NUMEXPRP -> ε
+                continue;
+            case 22: // +
+                // NUMEXPRP -> + TERM NUMEXPRP
+                s[top + 0] = 48; // NUMEXPRP
+                s[top + 1] = 49; // TERM
+                top += 2;
+                i++;
+                continue;
+            case 23: // -
+                // NUMEXPRP -> - TERM NUMEXPRP
+                s[top + 0] = 48; // NUMEXPRP
+                s[top + 1] = 49; // TERM
+                top += 2;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 21;
+            goto syntax_error;
+        case 49: // TERM
+            switch (type)
+            {
+            case 2: // id
+                // TERM -> FACTOR TERMP > FACTOR -> id FACTORP
+                s[top + 0] = 50; // TERMP
+                s[top + 1] = 52; // FACTORP
+                top += 2;
+                i++;
+                continue;
+            case 3: // num
+                // TERM -> FACTOR TERMP > FACTOR -> num
+                s[top + 0] = 50; // TERMP
+                top += 1;
+                i++;
+                continue;
+            case 10: // (
+                // TERM -> FACTOR TERMP > FACTOR -> ( NUMEXPR )
+                s[top + 0] = 50; // TERMP
+                s[top + 1] = 11; // )
+                s[top + 2] = 47; // NUMEXPR
+                top += 3;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 22;
+            goto syntax_error;
+        case 50: // TERMP
+            switch (type)
+            {
+            case 11: // )
+                // TERMP -> ε
+                continue;
+            case 13: // ;
+                // TERMP -> ε
+                continue;
+            case 15: // <
+                // TERMP -> ε
+                continue;
+            case 16: // <=
+                // TERMP -> ε
+                continue;
+            case 17: // >
+                // TERMP -> ε
+                continue;
+            case 18: // >=
+                // TERMP -> ε
+                continue;
+            case 20: // <>
+                // TERMP -> ε
+                continue;
+            case 21: // ==
+                // TERMP -> ε
+                continue;
+            case 22: // +
+                // TERMP -> ε
+                continue;
+            case 23: // -
+                // TERMP -> ε
+                continue;
+            case 24: // *
+                // TERMP -> * FACTOR TERMP
+                s[top + 0] = 50; // TERMP
+                s[top + 1] = 51; // FACTOR
+                top += 2;
+                i++;
+                continue;
+            case 25: // /
+                // TERMP -> / FACTOR TERMP
+                s[top + 0] = 50; // TERMP
+                s[top + 1] = 51; // FACTOR
+                top += 2;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 23;
+            goto syntax_error;
+        case 51: // FACTOR
+            switch (type)
+            {
+            case 2: // id
+                // FACTOR -> id FACTORP
+                s[top + 0] = 52; // FACTORP
+                top += 1;
+                i++;
+                continue;
+            case 3: // num
+                // FACTOR -> num
+                i++;
+                continue;
+            case 10: // (
+                // FACTOR -> ( NUMEXPR )
+                s[top + 0] = 11; // )
+                s[top + 1] = 47; // NUMEXPR
+                top += 2;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 24;
+            goto syntax_error;
+        case 52: // FACTORP
+            switch (type)
+            {
+            case 10: // (
+                // FACTORP -> ( PARLISTCALL )
+                s[top + 0] = 11; // )
+                s[top + 1] = 53; // PARLISTCALL
+                top += 2;
+                i++;
+                continue;
+            case 11: // )
+                // FACTORP -> ε
+                continue;
+            case 13: // ;
+                // FACTORP -> ε
+                continue;
+            case 15: // <
+                // FACTORP -> ε
+                continue;
+            case 16: // <=
+                // FACTORP -> ε
+                continue;
+            case 17: // >
+                // FACTORP -> ε
+                continue;
+            case 18: // >=
+                // FACTORP -> ε
+                continue;
+            case 20: // <>
+                // FACTORP -> ε
+                continue;
+            case 21: // ==
+                // FACTORP -> ε
+                continue;
+            case 22: // +
+                // FACTORP -> ε
+                continue;
+            case 23: // -
+                // FACTORP -> ε
+                continue;
+            case 24: // *
+                // FACTORP -> ε
+                continue;
+            case 25: // /
+                // FACTORP -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 25;
+            goto syntax_error;
+        case 53: // PARLISTCALL
+            switch (type)
+            {
+            case 2: // id
+                // PARLISTCALL -> id PARLISTCALLP
+                s[top + 0] = 54; // PARLISTCALLP
+                top += 1;
+                i++;
+                continue;
+            case 11: // )
+                // PARLISTCALL -> ε
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 26;
+            goto syntax_error;
+        case 54: // PARLISTCALLP
+            switch (type)
+            {
+            case 11: // )
+                // PARLISTCALLP -> ε
+                continue;
+            case 12: // ,
+                // PARLISTCALLP -> , id PARLISTCALLP
+                s[top + 0] = 54; // PARLISTCALLP
+                s[top + 1] = 2; // id
+                top += 2;
+                i++;
+                continue;
+            }
+            error->expected = -1;
+            error->nonterminal = 27;
+            goto syntax_error;
+        default:
+            return PARSE_EMPTY_STACK;
+        }
+    }
+
+syntax_error:
+    error->index = i;
+    return PARSE_SYNTAX_ERROR;
+}
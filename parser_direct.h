@@ -0,0 +1,34 @@
+#ifndef PARSER_DIRECT_H
+#define PARSER_DIRECT_H
+
+#include "lexer.h"
+
+// Motor de análise gerado como código (parser_direct.c, ./gen_table --direct):
+// a tabela LL(1) e as expansões encadeadas viram um switch por símbolo do
+// topo e por lookahead, com os símbolos empilhados como constantes. Faz a
+// mesma análise do laço interpretado, sem trace, árvore ou recuperação.
+// Compilado com -DPARSER_DIRECT, o parser o usa sempre que esses recursos
+// estão desligados.
+
+// Pilha do motor, reaproveitada entre análises (cresce com counted_realloc)
+typedef struct
+{
+    symbol_t *data;
+    size_t capacity;
+} DirectStack;
+
+// Onde e por que a análise falhou (com PARSE_SYNTAX_ERROR)
+typedef struct
+{
+    size_t index;    // token do erro (count se for o fim da entrada)
+    int expected;    // terminal esperado, ou -1
+    int nonterminal; // não-terminal sem produção para o lookahead, ou -1
+} DirectError;
+
+// Analisa tokens[begin, count) a partir do não-terminal start; end_marker,
+// se não for NULL, é o lookahead depois do último token: um '$' virtual ou o
+// início do trecho seguinte (como em parser_parse_range)
+ParseStatus direct_parse(const Token *tokens, size_t begin, size_t count, int start, const Token *end_marker,
+                         DirectStack *stack, DirectError *error);
+
+#endif
@@ -0,0 +1,321 @@
+#include "semantic.h"
+#include "arena.h"
+
+// Contexto de identificador na passada linear
+typedef enum
+{
+    IN_BODY,      // uso de variável (ou início de chamada)
+    IN_FUNC_NAME, // depois de 'def'
+    IN_PARAMS,    // entre os parênteses da definição
+    IN_DECL,      // depois de 'int', até ';'
+    IN_CALL       // entre os parênteses de uma chamada
+} Context;
+
+// Chamada a uma função ainda não definida no ponto da chamada, verificada no fim
+typedef struct
+{
+    size_t token_index;
+    uint32_t callee;
+    uint32_t function;
+    int args;
+} PendingCall;
+
+typedef struct
+{
+    const char *src;
+    const Token *tokens;
+    SemanticResult *out;
+
+    // Vetores indexados pelo ID do identificador. var_scope guarda o número da
+    // função em que a variável foi declarada: trocar de função é só incrementar
+    // o número atual, sem limpar nada.
+    uint32_t *var_scope;
+    int *arity; // parâmetros da função com esse nome, ou -1
+    uint32_t num_ids;
+
+    PendingCall *pending;
+    size_t num_pending, pending_capacity;
+} Checker;
+
+static int grow_ids(Checker *c)
+{
+    uint32_t n = c->out->symbols.capacity;
+    uint32_t *var_scope = counted_realloc(c->var_scope, n * sizeof(uint32_t));
+    if (var_scope == NULL)
+    {
+        return -1;
+    }
+    c->var_scope = var_scope;
+    int *arity = counted_realloc(c->arity, n * sizeof(int));
+    if (arity == NULL)
+    {
+        return -1;
+    }
+    c->arity = arity;
+    for (uint32_t i = c->num_ids; i < n; i++)
+    {
+        c->var_scope[i] = 0;
+        c->arity[i] = -1;
+    }
+    c->num_ids = n;
+    return 0;
+}
+
+// ID do identificador no token i, ou SYMTAB_NONE se faltar memória
+static uint32_t intern_token(Checker *c, size_t i)
+{
+    const Token *tk = &c->tokens[i];
+    uint32_t id = symtab_intern(&c->out->symbols, c->src + tk->offset, tk->length);
+    if (id != SYMTAB_NONE && id >= c->num_ids && grow_ids(c) != 0)
+    {
+        return SYMTAB_NONE;
+    }
+    return id;
+}
+
+static int report(Checker *c, SemanticError kind, size_t i, uint32_t symbol, uint32_t function, int expected,
+                  int found)
+{
+    SemanticResult *r = c->out;
+    if (r->count == r->capacity)
+    {
+        size_t capacity = r->capacity ? r->capacity * 2 : 16;
+        SemanticDiagnostic *diagnostics = counted_realloc(r->diagnostics, capacity * sizeof(SemanticDiagnostic));
+        if (diagnostics == NULL)
+        {
+            return -1;
+        }
+        r->diagnostics = diagnostics;
+        r->capacity = capacity;
+    }
+    r->diagnostics[r->count++] = (SemanticDiagnostic){kind, i, c->tokens[i].offset, symbol, function, expected, found};
+    return 0;
+}
+
+static int defer_call(Checker *c, size_t i, uint32_t callee, uint32_t function, int args)
+{
+    if (c->num_pending == c->pending_capacity)
+    {
+        size_t capacity = c->pending_capacity ? c->pending_capacity * 2 : 16;
+        PendingCall *pending = counted_realloc(c->pending, capacity * sizeof(PendingCall));
+        if (pending == NULL)
+        {
+            return -1;
+        }
+        c->pending = pending;
+        c->pending_capacity = capacity;
+    }
+    c->pending[c->num_pending++] = (PendingCall){i, callee, function, args};
+    return 0;
+}
+
+static int check_call(Checker *c, size_t i, uint32_t callee, uint32_t function, int args)
+{
+    if (c->arity[callee] < 0)
+    {
+        return report(c, SEM_UNDEFINED_FUNCTION, i, callee, function, -1, args);
+    }
+    if (c->arity[callee] != args)
+    {
+        return report(c, SEM_ARGUMENT_COUNT, i, callee, function, c->arity[callee], args);
+    }
+    return 0;
+}
+
+static int compare_diagnostics(const void *a, const void *b)
+{
+    size_t x = ((const SemanticDiagnostic *)a)->token_index, y = ((const SemanticDiagnostic *)b)->token_index;
+    return (x > y) - (x < y);
+}
+
+static int check(Checker *c, size_t count)
+{
+    // Um programa sem 'def' (MAIN ::= STMT) é um único escopo
+    uint32_t scope = 1, function = SYMTAB_NONE;
+    int counting = 0; // os parâmetros contam para a aridade de function
+    Context context = IN_BODY;
+    uint32_t callee = SYMTAB_NONE;
+    size_t call_index = 0;
+    int args = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        switch (c->tokens[i].type)
+        {
+        case T_DEF:
+            scope++;
+            function = SYMTAB_NONE;
+            context = IN_FUNC_NAME;
+            break;
+        case T_INT:
+            if (context == IN_BODY)
+            {
+                context = IN_DECL;
+            }
+            break;
+        case T_LPAREN:
+            if (context == IN_FUNC_NAME)
+            {
+                context = IN_PARAMS;
+            }
+            break;
+        case T_RPAREN:
+            if (context == IN_PARAMS)
+            {
+                context = IN_BODY;
+            }
+            else if (context == IN_CALL)
+            {
+                context = IN_BODY;
+                // Função já definida: verifica agora; senão, no fim
+                int status = c->arity[callee] >= 0 ? check_call(c, call_index, callee, function, args)
+                                                   : defer_call(c, call_index, callee, function, args);
+                if (status != 0)
+                {
+                    return -1;
+                }
+            }
+            break;
+        case T_SEMICOLON:
+            if (context == IN_DECL)
+            {
+                context = IN_BODY;
+            }
+            break;
+        case T_ID:
+        {
+            uint32_t id = intern_token(c, i);
+            if (id == SYMTAB_NONE)
+            {
+                return -1;
+            }
+            int status = 0;
+            switch (context)
+            {
+            case IN_FUNC_NAME:
+                function = id;
+                if (c->arity[id] >= 0)
+                {
+                    // Vale a primeira definição; os parâmetros desta não são contados
+                    status = report(c, SEM_REDEFINED_FUNCTION, i, id, SYMTAB_NONE, -1, -1);
+                    counting = 0;
+                }
+                else
+                {
+                    c->arity[id] = 0;
+                    counting = 1;
+                }
+                break;
+            case IN_PARAMS:
+            case IN_DECL:
+                if (c->var_scope[id] == scope)
+                {
+                    status = report(c, SEM_REDECLARED_VARIABLE, i, id, function, -1, -1);
+                }
+                c->var_scope[id] = scope;
+                if (context == IN_PARAMS && counting)
+                {
+                    c->arity[function]++;
+                }
+                break;
+            case IN_BODY:
+            case IN_CALL:
+                if (context == IN_BODY && i + 1 < count && c->tokens[i + 1].type == T_LPAREN)
+                {
+                    // Início de chamada: os próximos identificadores são argumentos
+                    context = IN_CALL;
+                    callee = id;
+                    call_index = i;
+                    args = 0;
+                    i++;
+                    break;
+                }
+                if (context == IN_CALL)
+                {
+                    args++;
+                }
+                if (c->var_scope[id] != scope)
+                {
+                    status = report(c, SEM_UNDECLARED_VARIABLE, i, id, function, -1, -1);
+                }
+                break;
+            }
+            if (status != 0)
+            {
+                return -1;
+            }
+            break;
+        }
+        default:
+            break;
+        }
+    }
+
+    for (size_t k = 0; k < c->num_pending; k++)
+    {
+        const PendingCall *call = &c->pending[k];
+        if (check_call(c, call->token_index, call->callee, call->function, call->args) != 0)
+        {
+            return -1;
+        }
+    }
+    if (c->num_pending > 0 && c->out->count > 1)
+    {
+        qsort(c->out->diagnostics, c->out->count, sizeof(SemanticDiagnostic), compare_diagnostics);
+    }
+    return 0;
+}
+
+// Executa a análise; out recebe a tabela de identificadores e os diagnósticos.
+// Retorna o número de diagnósticos ou -1 se faltar memória.
+int semantic_check(const char *src, const TokenArray *tokens, SemanticResult *out)
+{
+    memset(out, 0, sizeof(*out));
+    symtab_init(&out->symbols);
+    Checker c = {src, tokens->tokens, out, NULL, NULL, 0, NULL, 0, 0};
+    int status = check(&c, tokens->count);
+    free(c.var_scope);
+    free(c.arity);
+    free(c.pending);
+    return status == 0 ? (int)out->count : -1;
+}
+
+// Formata o diagnóstico, sem quebra de linha
+int semantic_message(const SemanticResult *r, const SemanticDiagnostic *d, char *buf, size_t size)
+{
+    uint32_t len, function_len = 0;
+    const char *name = symtab_name(&r->symbols, d->symbol, &len);
+    const char *function = "";
+    if (d->function != SYMTAB_NONE)
+    {
+        function = symtab_name(&r->symbols, d->function, &function_len);
+    }
+
+    switch (d->kind)
+    {
+    case SEM_UNDECLARED_VARIABLE:
+        if (d->function == SYMTAB_NONE)
+        {
+            return snprintf(buf, size, "Erro semântico: Variável '%.*s' não declarada", (int)len, name);
+        }
+        return snprintf(buf, size, "Erro semântico: Variável '%.*s' não declarada em '%.*s'", (int)len, name,
+                        (int)function_len, function);
+    case SEM_REDECLARED_VARIABLE:
+        return snprintf(buf, size, "Erro semântico: Variável '%.*s' declarada mais de uma vez", (int)len, name);
+    case SEM_REDEFINED_FUNCTION:
+        return snprintf(buf, size, "Erro semântico: Função '%.*s' definida mais de uma vez", (int)len, name);
+    case SEM_UNDEFINED_FUNCTION:
+        return snprintf(buf, size, "Erro semântico: Função '%.*s' não definida", (int)len, name);
+    case SEM_ARGUMENT_COUNT:
+    default:
+        return snprintf(buf, size, "Erro semântico: Função '%.*s' espera %d argumento(s), recebeu %d", (int)len, name,
+                        d->expected, d->found);
+    }
+}
+
+void semantic_free(SemanticResult *r)
+{
+    symtab_free(&r->symbols);
+    free(r->diagnostics);
+    memset(r, 0, sizeof(*r));
+}
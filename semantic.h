@@ -0,0 +1,43 @@
+#ifndef SEMANTIC_H
+#define SEMANTIC_H
+
+#include "lexer.h"
+#include "symtab.h"
+
+// Análise semântica em uma única passada pela sequência de tokens de um
+// programa sintaticamente válido: variáveis declaradas (int VARLIST ou
+// PARLIST) antes do uso, funções definidas uma única vez e chamadas com o
+// número certo de argumentos. Cada função é um escopo plano.
+typedef enum
+{
+    SEM_UNDECLARED_VARIABLE,
+    SEM_REDECLARED_VARIABLE,
+    SEM_REDEFINED_FUNCTION,
+    SEM_UNDEFINED_FUNCTION,
+    SEM_ARGUMENT_COUNT
+} SemanticError;
+
+typedef struct
+{
+    SemanticError kind;
+    size_t token_index;
+    uint32_t offset;   // posição do identificador no fonte
+    uint32_t symbol;   // ID do identificador
+    uint32_t function; // ID da função em que o erro ocorreu, ou SYMTAB_NONE
+    int expected;      // SEM_ARGUMENT_COUNT: parâmetros declarados
+    int found;         // SEM_ARGUMENT_COUNT: argumentos passados
+} SemanticDiagnostic;
+
+typedef struct
+{
+    SymbolTable symbols;
+    SemanticDiagnostic *diagnostics; // em ordem do fonte
+    size_t count;
+    size_t capacity;
+} SemanticResult;
+
+int semantic_check(const char *src, const TokenArray *tokens, SemanticResult *out);
+int semantic_message(const SemanticResult *r, const SemanticDiagnostic *d, char *buf, size_t size);
+void semantic_free(SemanticResult *r);
+
+#endif
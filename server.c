@@ -0,0 +1,582 @@
+#include "server.h"
+#include "parser.h"
+#include "source.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+// Buffer de bytes que cresce geometricamente
+typedef struct
+{
+    unsigned char *data;
+    size_t len;
+    size_t cap;
+} Buffer;
+
+static int buffer_reserve(Buffer *b, size_t extra)
+{
+    if (b->cap - b->len >= extra)
+    {
+        return 0;
+    }
+    size_t cap = b->cap ? b->cap : 65536;
+    while (cap - b->len < extra)
+    {
+        cap *= 2;
+    }
+    unsigned char *data = realloc(b->data, cap);
+    if (data == NULL)
+    {
+        return -1;
+    }
+    b->data = data;
+    b->cap = cap;
+    return 0;
+}
+
+static int append_response(Buffer *out, int status, size_t tokens, const char *message)
+{
+    size_t n = strlen(message);
+    if (buffer_reserve(out, 12 + n) != 0)
+    {
+        return -1;
+    }
+    unsigned char *p = out->data + out->len;
+    server_put32(p, (uint32_t)(8 + n));
+    server_put32(p + 4, (uint32_t)status);
+    server_put32(p + 8, tokens > UINT32_MAX ? UINT32_MAX : (uint32_t)tokens);
+    memcpy(p + 12, message, n);
+    out->len += 12 + n;
+    return 0;
+}
+
+// Valida um buffer como o modo lote valida um arquivo e acrescenta a resposta
+static int validate(Parser *parser, const unsigned char *src, uint32_t len, Buffer *out)
+{
+    SourceFile source = {(const char *)src, len, 0};
+    size_t content;
+    char message[256];
+    if (!source_ends_with_marker(&source, &content))
+    {
+        snprintf(message, sizeof(message), "Erro: A entrada deve terminar com '$'.");
+        return append_response(out, PARSE_NO_END_MARKER, 0, message);
+    }
+    ParseStatus status = parser_parse_buffer(parser, source.data, content);
+    parser_message(parser, message, sizeof(message));
+    return append_response(out, status, parser_token_count(parser), message);
+}
+
+static int write_all(int fd, const unsigned char *data, size_t len)
+{
+    while (len > 0)
+    {
+        ssize_t n = write(fd, data, len);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            return -1;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return 0;
+}
+
+// Valida as requisições completas de input a partir de *start e acumula as
+// respostas em output. Retorna -1 se a conexão deve ser encerrada depois de
+// enviar as respostas (requisição grande demais ou falta de memória).
+static int validate_pending(Parser *parser, Buffer *input, size_t *start, Buffer *output)
+{
+    while (input->len - *start >= 4)
+    {
+        uint32_t n = server_get32(input->data + *start);
+        if (n > SERVER_MAX_REQUEST)
+        {
+            append_response(output, SERVER_BAD_REQUEST, 0, "Erro: Requisição grande demais.");
+            return -1;
+        }
+        if (input->len - *start - 4 < n)
+        {
+            break;
+        }
+        if (validate(parser, input->data + *start + 4, n, output) != 0)
+        {
+            return -1;
+        }
+        *start += 4 + (size_t)n;
+    }
+    return 0;
+}
+
+// Move a requisição incompleta para o início e reserva espaço para ela
+// inteira, se o tamanho já é conhecido
+static int compact_input(Buffer *input, size_t *start)
+{
+    memmove(input->data, input->data + *start, input->len - *start);
+    input->len -= *start;
+    *start = 0;
+    size_t needed = input->len >= 4 ? 4 + (size_t)server_get32(input->data) - input->len : 4;
+    return buffer_reserve(input, needed > 65536 ? needed : 65536);
+}
+
+// Atende uma conexão até o fim da entrada. Todas as requisições completas já
+// recebidas são validadas antes de escrever, e as respostas saem juntas numa
+// única escrita: com pipeline, o custo de chamadas ao sistema é dividido.
+static void serve_stream(Parser *parser, int in, int out)
+{
+    Buffer input = {NULL, 0, 0}, output = {NULL, 0, 0};
+    size_t start = 0; // início da próxima requisição em input
+
+    while (1)
+    {
+        int fatal = validate_pending(parser, &input, &start, &output) != 0;
+        if (output.len > 0 && write_all(out, output.data, output.len) != 0)
+        {
+            break;
+        }
+        output.len = 0;
+        if (fatal || compact_input(&input, &start) != 0)
+        {
+            break;
+        }
+
+        ssize_t n = read(in, input.data + input.len, input.cap - input.len);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n <= 0)
+        {
+            break;
+        }
+        input.len += (size_t)n;
+    }
+    free(input.data);
+    free(output.data);
+}
+
+// Conexão do socket. Entre uma leitura e outra ela fica com a thread do
+// accept, que espera por dados em todas as conexões ociosas com poll; quando
+// chegam dados, a conexão vai para a fila e uma thread do pool lê, valida as
+// requisições completas, responde e a devolve. Uma conexão ociosa não ocupa
+// thread nenhuma, e as respostas de uma conexão saem na ordem de envio porque
+// ela está com no máximo uma thread por vez.
+typedef struct
+{
+    int fd;
+    Buffer input;
+    size_t start; // início da próxima requisição em input
+} Connection;
+
+typedef struct
+{
+    Connection **items;
+    size_t count;
+    size_t capacity;
+} ConnectionList;
+
+static int list_push(ConnectionList *list, Connection *c)
+{
+    if (list->count == list->capacity)
+    {
+        size_t capacity = list->capacity ? list->capacity * 2 : 64;
+        Connection **items = realloc(list->items, capacity * sizeof(Connection *));
+        if (items == NULL)
+        {
+            return -1;
+        }
+        list->items = items;
+        list->capacity = capacity;
+    }
+    list->items[list->count++] = c;
+    return 0;
+}
+
+typedef struct
+{
+    pthread_mutex_t lock;
+    pthread_cond_t ready;
+    ConnectionList pending;  // com dados para ler, na ordem de chegada
+    size_t head;             // próxima de pending a ser atendida
+    ConnectionList returned; // atendidas, à espera de voltar para o poll
+    int wake[2];             // pipe que acorda o poll quando uma conexão volta
+} Server;
+
+static int queue_push(Server *s, Connection *c)
+{
+    pthread_mutex_lock(&s->lock);
+    if (s->head > 0)
+    {
+        memmove(s->pending.items, s->pending.items + s->head, (s->pending.count - s->head) * sizeof(Connection *));
+        s->pending.count -= s->head;
+        s->head = 0;
+    }
+    int status = list_push(&s->pending, c);
+    pthread_cond_signal(&s->ready);
+    pthread_mutex_unlock(&s->lock);
+    return status;
+}
+
+static Connection *queue_pop(Server *s)
+{
+    pthread_mutex_lock(&s->lock);
+    while (s->head == s->pending.count)
+    {
+        pthread_cond_wait(&s->ready, &s->lock);
+    }
+    Connection *c = s->pending.items[s->head++];
+    pthread_mutex_unlock(&s->lock);
+    return c;
+}
+
+static void close_connection(Connection *c)
+{
+    close(c->fd);
+    free(c->input.data);
+    free(c);
+}
+
+// Lê o que a conexão tem disponível (sem bloquear, até ter ao menos uma
+// requisição completa), valida as requisições completas e responde numa única
+// escrita. Retorna -1 se a conexão terminou ou deve ser encerrada.
+static int serve_ready(Parser *parser, Connection *c, Buffer *output)
+{
+    int eof = 0;
+    while (1)
+    {
+        if (compact_input(&c->input, &c->start) != 0)
+        {
+            return -1;
+        }
+        ssize_t n = recv(c->fd, c->input.data + c->input.len, c->input.cap - c->input.len, MSG_DONTWAIT);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+        {
+            break;
+        }
+        if (n <= 0)
+        {
+            eof = 1;
+            break;
+        }
+        c->input.len += (size_t)n;
+        if (c->input.len >= 4 && c->input.len - 4 >= server_get32(c->input.data))
+        {
+            break;
+        }
+    }
+
+    output->len = 0;
+    int fatal = validate_pending(parser, &c->input, &c->start, output) != 0;
+    if (output->len > 0 && write_all(c->fd, output->data, output->len) != 0)
+    {
+        return -1;
+    }
+    return (fatal || eof) ? -1 : 0;
+}
+
+typedef struct
+{
+    Server *server;
+    Parser *parser;
+} ServerWorker;
+
+// Cada thread tem o próprio contexto, criado antes de o socket abrir e
+// reaproveitado entre requisições de todas as conexões: a arena e o vetor de
+// tokens já estão no tamanho das requisições anteriores
+static void *server_worker(void *arg)
+{
+    ServerWorker *w = arg;
+    Server *s = w->server;
+    Parser *parser = w->parser;
+    Buffer output = {NULL, 0, 0};
+    while (1)
+    {
+        Connection *c = queue_pop(s);
+        if (serve_ready(parser, c, &output) != 0)
+        {
+            close_connection(c);
+            continue;
+        }
+        pthread_mutex_lock(&s->lock);
+        int status = list_push(&s->returned, c);
+        pthread_mutex_unlock(&s->lock);
+        if (status != 0)
+        {
+            close_connection(c); // sem memória: encerra a conexão
+            continue;
+        }
+        char byte = 0;
+        (void)!write(s->wake[1], &byte, 1); // pipe cheio: o poll já vai acordar
+    }
+    return NULL;
+}
+
+static volatile sig_atomic_t stop_requested = 0;
+
+static void request_stop(int signal)
+{
+    (void)signal;
+    stop_requested = 1;
+}
+
+static int serve_socket(const char *path, long num_workers)
+{
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path))
+    {
+        printf("Erro: Caminho do socket longo demais.\n");
+        return 1;
+    }
+    strcpy(addr.sun_path, path);
+
+    // Os contextos são criados antes de abrir o socket: sem memória para
+    // eles, o servidor não sobe, em vez de deixar conexões sem thread
+    ServerWorker *workers = calloc((size_t)num_workers, sizeof(ServerWorker));
+    for (long i = 0; workers != NULL && i < num_workers; i++)
+    {
+        workers[i].parser = parser_create();
+        if (workers[i].parser == NULL)
+        {
+            for (long k = 0; k < i; k++)
+            {
+                parser_destroy(workers[k].parser);
+            }
+            free(workers);
+            workers = NULL;
+        }
+    }
+    if (workers == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+
+    Server server = {PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, {NULL, 0, 0}, 0, {NULL, 0, 0}, {-1, -1}};
+    if (pipe(server.wake) != 0 || fcntl(server.wake[0], F_SETFL, O_NONBLOCK) != 0 ||
+        fcntl(server.wake[1], F_SETFL, O_NONBLOCK) != 0)
+    {
+        perror("Erro ao criar o pipe");
+        return 1;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        perror("Erro ao criar o socket");
+        return 1;
+    }
+    // Só remove o caminho se for um socket deixado por uma execução anterior
+    struct stat st;
+    if (lstat(path, &st) == 0)
+    {
+        if (!S_ISSOCK(st.st_mode))
+        {
+            fprintf(stderr, "Erro: '%s' existe e não é um socket.\n", path);
+            close(listener);
+            return 1;
+        }
+        unlink(path);
+    }
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0 || listen(listener, 128) != 0)
+    {
+        perror("Erro ao abrir o socket");
+        close(listener);
+        return 1;
+    }
+
+    // SIGINT e SIGTERM interrompem o poll (sem SA_RESTART) e removem o socket
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = request_stop;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    // As threads herdam a máscara: os sinais ficam só com a thread principal,
+    // a única que espera no poll e olha stop_requested
+    sigset_t stop_signals, old_mask;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+    for (long i = 0; i < num_workers; i++)
+    {
+        pthread_t thread;
+        workers[i].server = &server;
+        if (pthread_create(&thread, NULL, server_worker, &workers[i]) != 0)
+        {
+            perror("Erro ao criar as threads");
+            pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+            close(listener);
+            unlink(path);
+            return 1;
+        }
+        pthread_detach(thread);
+    }
+    pthread_sigmask(SIG_SETMASK, &old_mask, NULL);
+    fprintf(stderr, "Servidor em %s com %ld threads\n", path, num_workers);
+
+    // Conexões ociosas: esperam dados no poll, junto com o socket e o pipe
+    ConnectionList idle = {NULL, 0, 0};
+    struct pollfd *fds = NULL;
+    size_t fds_capacity = 0;
+    int status = 0;
+    while (!stop_requested)
+    {
+        if (fds_capacity < idle.count + 2)
+        {
+            size_t capacity = fds_capacity ? fds_capacity : 64;
+            while (capacity < idle.count + 2)
+            {
+                capacity *= 2;
+            }
+            struct pollfd *bigger = realloc(fds, capacity * sizeof(struct pollfd));
+            if (bigger == NULL)
+            {
+                printf("Erro: Falha ao alocar memória!\n");
+                status = 1;
+                break;
+            }
+            fds = bigger;
+            fds_capacity = capacity;
+        }
+        fds[0] = (struct pollfd){listener, POLLIN, 0};
+        fds[1] = (struct pollfd){server.wake[0], POLLIN, 0};
+        for (size_t i = 0; i < idle.count; i++)
+        {
+            fds[i + 2] = (struct pollfd){idle.items[i]->fd, POLLIN, 0};
+        }
+        size_t polled = idle.count;
+        if (poll(fds, polled + 2, -1) < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            perror("Erro no poll");
+            status = 1;
+            break;
+        }
+
+        // Conexões com dados (ou fechadas) vão para o pool; as outras ficam
+        size_t kept = 0;
+        for (size_t i = 0; i < polled; i++)
+        {
+            Connection *c = idle.items[i];
+            if (fds[i + 2].revents != 0)
+            {
+                if (queue_push(&server, c) != 0)
+                {
+                    close_connection(c); // sem memória: encerra a conexão
+                }
+            }
+            else
+            {
+                idle.items[kept++] = c;
+            }
+        }
+        idle.count = kept;
+
+        if (fds[1].revents != 0)
+        {
+            char drain[256];
+            while (read(server.wake[0], drain, sizeof(drain)) > 0)
+            {
+            }
+            pthread_mutex_lock(&server.lock);
+            for (size_t i = 0; i < server.returned.count; i++)
+            {
+                if (list_push(&idle, server.returned.items[i]) != 0)
+                {
+                    close_connection(server.returned.items[i]);
+                }
+            }
+            server.returned.count = 0;
+            pthread_mutex_unlock(&server.lock);
+        }
+
+        if (fds[0].revents != 0)
+        {
+            int fd = accept(listener, NULL, NULL);
+            if (fd < 0)
+            {
+                if (errno == EINTR || errno == ECONNABORTED)
+                {
+                    continue;
+                }
+                perror("Erro ao aceitar conexão");
+                status = 1;
+                break;
+            }
+            Connection *c = calloc(1, sizeof(Connection));
+            if (c == NULL || list_push(&idle, c) != 0)
+            {
+                free(c);
+                close(fd); // sem memória: recusa a conexão
+                continue;
+            }
+            c->fd = fd;
+        }
+    }
+    close(listener);
+    unlink(path);
+    return status;
+}
+
+int run_server(int argc, char *argv[])
+{
+    long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *path = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            num_workers = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "-u") == 0 && i + 1 < argc)
+        {
+            path = argv[++i];
+        }
+        else
+        {
+            printf("Uso: --serve [-j threads] [-u caminho_do_socket]\n");
+            return 1;
+        }
+    }
+    if (num_workers < 1)
+    {
+        num_workers = 1;
+    }
+
+    // Um cliente que desconecta no meio de uma resposta não derruba o servidor
+    signal(SIGPIPE, SIG_IGN);
+
+    if (path != NULL)
+    {
+        return serve_socket(path, num_workers);
+    }
+
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        fprintf(stderr, "Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    serve_stream(parser, STDIN_FILENO, STDOUT_FILENO);
+    parser_destroy(parser);
+    return 0;
+}
@@ -0,0 +1,36 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <stdint.h>
+
+// Modo servidor: um processo de longa duração que mantém contextos do parser
+// prontos e valida buffers enviados por um socket Unix ou pela entrada padrão.
+//
+// Protocolo (inteiros de 32 bits little-endian): cada requisição é
+//     tamanho, fonte[tamanho]
+// e cada resposta é
+//     tamanho, status, tokens, mensagem[tamanho - 8]
+// com status = ParseStatus (ou SERVER_BAD_REQUEST) e a mesma mensagem do modo
+// lote. Um cliente pode enviar várias requisições sem esperar as respostas
+// (pipeline); elas voltam na ordem de envio.
+#define SERVER_MAX_REQUEST (256u << 20)
+#define SERVER_BAD_REQUEST (-1)
+
+// argv contém as opções após "--serve": [-j threads] [-u caminho_do_socket].
+// Sem -u, atende um único cliente pela entrada e saída padrão.
+int run_server(int argc, char *argv[]);
+
+static inline void server_put32(unsigned char *p, uint32_t v)
+{
+    p[0] = (unsigned char)v;
+    p[1] = (unsigned char)(v >> 8);
+    p[2] = (unsigned char)(v >> 16);
+    p[3] = (unsigned char)(v >> 24);
+}
+
+static inline uint32_t server_get32(const unsigned char *p)
+{
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+#endif
@@ -0,0 +1,212 @@
+#include "source.h"
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char empty_source[] = "";
+
+// Lê o descritor até o fim para um buffer alocado
+static int read_all(SourceFile *sf, int fd)
+{
+    size_t capacity = 1 << 16, len = 0;
+    char *buffer = malloc(capacity);
+    while (buffer != NULL)
+    {
+        if (len == capacity)
+        {
+            char *bigger = realloc(buffer, capacity * 2);
+            if (bigger == NULL)
+            {
+                break;
+            }
+            buffer = bigger;
+            capacity *= 2;
+        }
+        ssize_t n = read(fd, buffer + len, capacity - len);
+        if (n < 0)
+        {
+            break;
+        }
+        if (n == 0)
+        {
+            sf->data = buffer;
+            sf->len = len;
+            sf->mapped = 0;
+            return 0;
+        }
+        len += (size_t)n;
+    }
+    free(buffer);
+    return -1;
+}
+
+// Abre o arquivo sem copiá-lo: o conteúdo é acessado direto do cache de páginas.
+// Retorna 0 em caso de sucesso e -1 em caso de erro (errno indica a causa).
+int source_open(SourceFile *sf, const char *path)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return -1;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    int status = 0;
+    if (S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        void *data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED)
+        {
+            status = read_all(sf, fd);
+        }
+        else
+        {
+            madvise(data, (size_t)st.st_size, MADV_SEQUENTIAL);
+            sf->data = data;
+            sf->len = (size_t)st.st_size;
+            sf->mapped = 1;
+        }
+    }
+    else if (S_ISREG(st.st_mode))
+    {
+        sf->data = empty_source;
+        sf->len = 0;
+        sf->mapped = 0;
+    }
+    else
+    {
+        status = read_all(sf, fd);
+    }
+
+    close(fd);
+    return status;
+}
+
+// Tamanho do conteúdo sem os espaços no final do arquivo
+size_t source_content_length(const SourceFile *sf)
+{
+    size_t len = sf->len;
+    while (len > 0 && isspace((unsigned char)sf->data[len - 1]))
+    {
+        len--;
+    }
+    return len;
+}
+
+// Verifica se o conteúdo termina com '$'; devolve em *len o tamanho sem os espaços finais
+int source_ends_with_marker(const SourceFile *sf, size_t *len)
+{
+    *len = source_content_length(sf);
+    return *len > 0 && sf->data[*len - 1] == '$';
+}
+
+void source_close(SourceFile *sf)
+{
+    if (sf->mapped)
+    {
+        munmap((void *)sf->data, sf->len);
+    }
+    else if (sf->data != NULL && sf->data != empty_source)
+    {
+        free((void *)sf->data);
+    }
+    sf->data = NULL;
+    sf->len = 0;
+    sf->mapped = 0;
+}
+
+void source_map_reset(SourceMap *m, const char *src)
+{
+    m->src = src;
+    m->count = 0;
+    m->scanned = 0;
+}
+
+static int add_line(SourceMap *m, size_t start)
+{
+    if (m->count == m->capacity)
+    {
+        size_t capacity = m->capacity ? m->capacity * 2 : 256;
+        size_t *starts = realloc(m->starts, capacity * sizeof(size_t));
+        if (starts == NULL)
+        {
+            return -1;
+        }
+        m->starts = starts;
+        m->capacity = capacity;
+    }
+    m->starts[m->count++] = start;
+    return 0;
+}
+
+int source_map_locate(SourceMap *m, size_t offset, SourcePosition *pos)
+{
+    if (m->count == 0 && add_line(m, 0) != 0)
+    {
+        return -1;
+    }
+    // Quebras de linha ainda não indexadas antes de offset
+    while (m->scanned < offset)
+    {
+        const char *nl = memchr(m->src + m->scanned, '\n', offset - m->scanned);
+        if (nl == NULL)
+        {
+            m->scanned = offset;
+            break;
+        }
+        size_t next = (size_t)(nl - m->src) + 1;
+        if (add_line(m, next) != 0)
+        {
+            return -1;
+        }
+        m->scanned = next;
+    }
+
+    // Última linha que começa em ou antes de offset
+    size_t lo = 0, hi = m->count;
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (m->starts[mid] <= offset)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    pos->line = (uint32_t)(lo + 1);
+    pos->line_start = m->starts[lo];
+    pos->column = (uint32_t)(source_count_chars(m->src + m->starts[lo], offset - m->starts[lo]) + 1);
+    return 0;
+}
+
+void source_map_free(SourceMap *m)
+{
+    free(m->starts);
+    m->starts = NULL;
+    m->count = 0;
+    m->capacity = 0;
+    m->scanned = 0;
+}
+
+size_t source_count_chars(const char *s, size_t n)
+{
+    size_t chars = 0;
+    for (size_t i = 0; i < n; i++)
+    {
+        chars += ((unsigned char)s[i] & 0xC0) != 0x80;
+    }
+    return chars;
+}
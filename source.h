@@ -0,0 +1,52 @@
+#ifndef SOURCE_H
+#define SOURCE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Arquivo de entrada mapeado em memória (somente leitura). Arquivos que não
+// podem ser mapeados (pipes, dispositivos) são lidos para um buffer.
+typedef struct
+{
+    const char *data;
+    size_t len;
+    int mapped;
+} SourceFile;
+
+int source_open(SourceFile *sf, const char *path);
+size_t source_content_length(const SourceFile *sf);
+int source_ends_with_marker(const SourceFile *sf, size_t *len);
+void source_close(SourceFile *sf);
+
+// Posição de um byte do fonte para diagnósticos: linha e coluna a partir de 1
+// (a coluna conta caracteres UTF-8) e o offset do início da linha
+typedef struct
+{
+    uint32_t line;
+    uint32_t column;
+    size_t line_start;
+} SourcePosition;
+
+// Índice dos inícios de linha, construído sob demanda: source_map_reset não
+// percorre nada (a análise de uma entrada aceita não paga pelas posições), e
+// cada source_map_locate só indexa o trecho ainda não visto até o offset
+// pedido; a linha sai por busca binária. Offsets pedidos em ordem crescente
+// (os erros de uma análise) percorrem o fonte uma única vez. O vetor é
+// reaproveitado entre fontes.
+typedef struct
+{
+    const char *src;
+    size_t *starts;  // inícios de linha já indexados; starts[0] = 0
+    size_t count;
+    size_t capacity;
+    size_t scanned;  // bytes [0, scanned) já percorridos
+} SourceMap;
+
+void source_map_reset(SourceMap *m, const char *src);
+int source_map_locate(SourceMap *m, size_t offset, SourcePosition *pos); // -1 se faltar memória
+void source_map_free(SourceMap *m);
+
+// Número de caracteres UTF-8 em s[0, n) (bytes que não são de continuação)
+size_t source_count_chars(const char *s, size_t n);
+
+#endif
@@ -0,0 +1,305 @@
+#include "split.h"
+#include "arena.h"
+#include "source.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+
+// Funções retiradas por vez do contador compartilhado
+#define SPLIT_CHUNK 64
+
+long split_functions(const TokenArray *tokens, size_t **starts)
+{
+    *starts = NULL;
+    size_t count = tokens->count;
+    if (count < 2 || tokens->tokens[0].type != T_DEF || tokens->tokens[count - 1].type != T_END)
+    {
+        return 0;
+    }
+
+    size_t n = 0, capacity = 256;
+    size_t *list = counted_malloc(capacity * sizeof(size_t));
+    if (list == NULL)
+    {
+        return -1;
+    }
+
+    // A análise termina no primeiro '$': o que vem depois fica no último trecho
+    long depth = 0;
+    for (size_t i = 0; i < count - 1 && tokens->tokens[i].type != T_END; i++)
+    {
+        int type = tokens->tokens[i].type;
+        if (type == T_LBRACE)
+        {
+            depth++;
+        }
+        else if (type == T_RBRACE && depth > 0)
+        {
+            depth--;
+        }
+        else if (type == T_DEF && depth == 0)
+        {
+            if (n == capacity)
+            {
+                size_t *bigger = counted_realloc(list, capacity * 2 * sizeof(size_t));
+                if (bigger == NULL)
+                {
+                    free(list);
+                    return -1;
+                }
+                list = bigger;
+                capacity *= 2;
+            }
+            list[n++] = i;
+        }
+    }
+    *starts = list;
+    return (long)n;
+}
+
+typedef struct
+{
+    const char *src;
+    const TokenArray *tokens;
+    const size_t *starts;
+    size_t num_functions;
+    ParseResult *results;
+    atomic_size_t next;
+} SplitJob;
+
+// Fim (exclusivo) do trecho da função i: o próximo 'def' ou o '$' final. O
+// último trecho inclui o primeiro '$' e o que vier depois dele, como na
+// análise sequencial, que para ao aceitar o primeiro '$'
+static size_t function_end(const SplitJob *job, size_t i)
+{
+    return i + 1 < job->num_functions ? job->starts[i + 1] : job->tokens->count - 1;
+}
+
+static void *split_worker(void *arg)
+{
+    SplitJob *job = arg;
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        return NULL;
+    }
+
+    while (1)
+    {
+        size_t first = atomic_fetch_add(&job->next, SPLIT_CHUNK);
+        if (first >= job->num_functions)
+        {
+            break;
+        }
+        size_t last = first + SPLIT_CHUNK < job->num_functions ? first + SPLIT_CHUNK : job->num_functions;
+        for (size_t i = first; i < last; i++)
+        {
+            // FLIST ::= FDEF FLISTP: o lookahead depois do trecho é o 'def'
+            // da função seguinte (ou o '$' final), então o trecho é aceito
+            // quando FLISTP o receberia, e um erro no fim do trecho cita o
+            // mesmo token, terminal e não-terminal da análise sequencial
+            parser_parse_range(parser, job->src, job->tokens, job->starts[i], function_end(job, i), N_FLIST, NULL);
+            job->results[i] = *parser_result(parser);
+        }
+    }
+
+    parser_destroy(parser);
+    return NULL;
+}
+
+long split_parse(const char *src, const TokenArray *tokens, const size_t *starts, size_t num_functions,
+                 long num_workers, ParseResult *results)
+{
+    SplitJob job = {src, tokens, starts, num_functions, results, 0};
+    pthread_t *threads = malloc(sizeof(pthread_t) * (size_t)num_workers);
+    if (threads == NULL)
+    {
+        return -1;
+    }
+    for (size_t i = 0; i < num_functions; i++)
+    {
+        results[i].status = PARSE_OUT_OF_MEMORY; // sobrescrito pelo worker
+    }
+
+    // As funções saem de um contador compartilhado: a thread que chamou tira
+    // blocos até acabarem, então uma thread que não pôde ser criada só deixa
+    // mais blocos para as outras
+    long running = 1;
+    for (long i = 1; i < num_workers; i++)
+    {
+        if (pthread_create(&threads[running], NULL, split_worker, &job) == 0)
+        {
+            running++;
+        }
+    }
+    split_worker(&job);
+    for (long i = 1; i < running; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+    return running;
+}
+
+static double now_seconds()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Análise sequencial, para programas que não são uma lista de funções
+static int run_whole(const char *src, const TokenArray *tokens)
+{
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    parser_set_verbosity(parser, TRACE_QUIET);
+    ParseStatus status = parser_parse_tokens(parser, src, tokens);
+    parser_destroy(parser);
+    if (status == PARSE_OUT_OF_MEMORY)
+    {
+        return 1;
+    }
+    return status == PARSE_ACCEPTED ? 0 : 2;
+}
+
+int run_split(int argc, char *argv[])
+{
+    long num_workers = sysconf(_SC_NPROCESSORS_ONLN);
+    const char *path = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc)
+        {
+            num_workers = atol(argv[++i]);
+        }
+        else if (path == NULL)
+        {
+            path = argv[i];
+        }
+    }
+    if (path == NULL)
+    {
+        printf("Uso: --split [-j threads] <caminho_para_arquivo>\n");
+        return 1;
+    }
+    if (num_workers < 1)
+    {
+        num_workers = 1;
+    }
+
+    SourceFile source;
+    if (source_open(&source, path) != 0)
+    {
+        perror("Erro ao abrir o arquivo");
+        return 1;
+    }
+    size_t len;
+    if (!source_ends_with_marker(&source, &len))
+    {
+        printf("Erro: A entrada deve terminar com '$'.\n");
+        source_close(&source);
+        return 1;
+    }
+    if (len > UINT32_MAX)
+    {
+        printf("Erro: O arquivo de entrada é muito grande (limite de 4 GiB).\n");
+        source_close(&source);
+        return 1;
+    }
+
+    TokenArray tokens = {0};
+    size_t *starts = NULL;
+    long num_functions = -1;
+    if (tokenize_input(source.data, len, &tokens) == 0)
+    {
+        num_functions = split_functions(&tokens, &starts);
+    }
+    if (num_functions < 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        token_array_free(&tokens);
+        source_close(&source);
+        return 1;
+    }
+    if (num_functions == 0)
+    {
+        int status = run_whole(source.data, &tokens);
+        token_array_free(&tokens);
+        source_close(&source);
+        return status;
+    }
+
+    size_t num = (size_t)num_functions;
+    ParseResult *results = counted_malloc(num * sizeof(ParseResult));
+    double t0 = now_seconds();
+    if (results == NULL || (num_workers = split_parse(source.data, &tokens, starts, num, num_workers, results)) < 0)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        free(results);
+        free(starts);
+        token_array_free(&tokens);
+        source_close(&source);
+        return 1;
+    }
+    double elapsed = now_seconds() - t0;
+
+    // Diagnósticos na ordem do fonte: no máximo o primeiro de cada função
+    size_t errors = 0, failed = 0;
+    SourceMap lines = {0};
+    source_map_reset(&lines, source.data);
+    for (size_t i = 0; i < num; i++)
+    {
+        const ParseResult *r = &results[i];
+        if (r->status == PARSE_ACCEPTED)
+        {
+            continue;
+        }
+        char message[160];
+        parse_result_message(r, source.data, message, sizeof(message));
+        if (r->status == PARSE_SYNTAX_ERROR)
+        {
+            errors++;
+            SourcePosition pos;
+            if (source_map_locate(&lines, r->offset, &pos) == 0)
+            {
+                printf("Função %zu (linha %u, coluna %u): %s\n", i + 1, pos.line, pos.column, message);
+            }
+            else
+            {
+                printf("Função %zu: %s\n", i + 1, message);
+            }
+        }
+        else
+        {
+            failed++;
+            printf("Função %zu: %s\n", i + 1, message);
+        }
+    }
+    if (errors == 0 && failed == 0)
+    {
+        printf("Entrada aceita!\n");
+    }
+    else
+    {
+        printf("Entrada rejeitada: %zu de %zu funções com erro.\n", errors + failed, num);
+    }
+    fprintf(stderr, "Tempo: %.3f s com %ld threads: %zu funções, %zu tokens, %.2f Mtokens/s\n", elapsed,
+            num_workers, num, tokens.count, tokens.count / elapsed / 1e6);
+
+    free(results);
+    free(starts);
+    source_map_free(&lines);
+    token_array_free(&tokens);
+    source_close(&source);
+    if (failed)
+    {
+        return 1;
+    }
+    return errors ? 2 : 0;
+}
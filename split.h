@@ -0,0 +1,24 @@
+#ifndef SPLIT_H
+#define SPLIT_H
+
+#include "lexer.h"
+
+// Divide o programa nas definições de função de nível superior: cada 'def'
+// com profundidade de chaves 0 antes do primeiro '$' inicia um trecho. Em
+// starts[0 .. n) ficam os índices dos tokens 'def'; o último trecho termina
+// no '$' final. Retorna o número de funções (0 se o programa não for uma
+// lista de funções) ou -1 se faltar memória.
+long split_functions(const TokenArray *tokens, size_t **starts);
+
+// Analisa as funções em paralelo com num_workers threads (a que chama é uma
+// delas); results[i] recebe o resultado da função i, com os índices e offsets
+// relativos ao programa inteiro. Retorna o número de threads usadas ou -1 se
+// faltar memória.
+long split_parse(const char *src, const TokenArray *tokens, const size_t *starts, size_t num_functions,
+                 long num_workers, ParseResult *results);
+
+// Modo dividido: analisa cada função de um arquivo em paralelo e junta os
+// diagnósticos na ordem do fonte. argv contém as opções e o arquivo após "--split".
+int run_split(int argc, char *argv[]);
+
+#endif
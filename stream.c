@@ -0,0 +1,240 @@
+#include "stream.h"
+#include "lexer.h"
+#include "arena.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// Lê até encher buf[*len, cap) ou chegar ao fim da entrada; retorna 1 no fim
+// (ou numa falha de leitura, guardada em r->read_error)
+static int fill(int fd, char *buf, size_t *len, size_t cap, StreamResult *r)
+{
+    while (*len < cap)
+    {
+        ssize_t n = read(fd, buf + *len, cap - *len);
+        if (n < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (n < 0)
+        {
+            r->read_error = errno;
+            return 1;
+        }
+        if (n == 0)
+        {
+            return 1;
+        }
+        *len += (size_t)n;
+        r->bytes += (uint64_t)n;
+    }
+    return 0;
+}
+
+// Último byte de s[0, n) que não é espaço (isspace no locale "C"), ou -1
+static int last_non_space(const char *s, size_t n)
+{
+    while (n > 0)
+    {
+        unsigned char c = (unsigned char)s[--n];
+        if (c != ' ' && (c < '\t' || c > '\r'))
+        {
+            return c;
+        }
+    }
+    return -1;
+}
+
+// Como no modo arquivo, a entrada só é aceita se terminar com '$': depois do
+// '$' que fecha o programa, o resto do fluxo é lido (sem lexer) só para
+// conferir que nada além de espaços vem depois do último '$'
+static int drain_ends_with_marker(int fd, char *buf, size_t cap, const char *rest, size_t rest_len, int eof,
+                                  StreamResult *r)
+{
+    int last = last_non_space(rest, rest_len);
+    int marker = last == -1 || last == '$';
+    while (!eof)
+    {
+        size_t len = 0;
+        eof = fill(fd, buf, &len, cap, r);
+        last = last_non_space(buf, len);
+        if (last != -1)
+        {
+            marker = last == '$';
+        }
+    }
+    return marker;
+}
+
+ParseStatus parse_stream(Parser *p, int fd, size_t chunk, StreamResult *r)
+{
+    memset(r, 0, sizeof(*r));
+    size_t cap = chunk ? chunk : STREAM_CHUNK;
+    char *buf = counted_malloc(cap);
+    TokenArray tokens = {NULL, 0, 0};
+    ParseStatus status = parser_feed_begin(p);
+    if (buf == NULL)
+    {
+        status = PARSE_OUT_OF_MEMORY;
+    }
+
+    size_t len = 0;   // bytes em buf
+    uint64_t base = 0; // posição no fluxo de buf[0]
+    int eof = 0, done = status != PARSE_ACCEPTED;
+    while (!done)
+    {
+        eof = fill(fd, buf, &len, cap, r);
+        if (tokenize_input(buf, len, &tokens) != 0)
+        {
+            status = PARSE_OUT_OF_MEMORY;
+            break;
+        }
+        // Um lexema que toca o fim do bloco pode continuar no próximo (ex.: '<'
+        // seguido de '='); ele fica para ser lido de novo junto com o resto
+        size_t usable = tokens.count, keep = len;
+        if (!eof && usable > 0 && tokens.tokens[usable - 1].offset + tokens.tokens[usable - 1].length == len)
+        {
+            keep = tokens.tokens[--usable].offset;
+        }
+
+        for (size_t i = 0; i < usable && !done; i++)
+        {
+            const Token *tk = &tokens.tokens[i];
+            if (parser_feed(p, buf, tk, &status))
+            {
+                done = 1;
+                r->tokens += i + (status == PARSE_ACCEPTED);
+                r->offset = base + tk->offset;
+                if (status == PARSE_SYNTAX_ERROR)
+                {
+                    parser_message(p, r->message, sizeof(r->message)); // o lexema ainda está em buf
+                }
+                else if (status == PARSE_ACCEPTED &&
+                         !drain_ends_with_marker(fd, buf, cap, buf + tk->offset + tk->length,
+                                                 len - tk->offset - tk->length, eof, r))
+                {
+                    status = PARSE_NO_END_MARKER;
+                }
+            }
+        }
+        if (done)
+        {
+            break;
+        }
+        r->tokens += usable;
+        if (eof)
+        {
+            // A entrada acabou sem o '$' final
+            status = PARSE_NO_END_MARKER;
+            r->offset = base + len;
+            break;
+        }
+
+        // Guarda o lexema incompleto no início; se ele ocupa o bloco inteiro
+        // (um identificador enorme), o buffer dobra
+        if (keep == 0 && len == cap)
+        {
+            char *bigger = counted_realloc(buf, cap * 2);
+            if (bigger == NULL)
+            {
+                status = PARSE_OUT_OF_MEMORY;
+                break;
+            }
+            buf = bigger;
+            cap *= 2;
+        }
+        memmove(buf, buf + keep, len - keep);
+        base += keep;
+        len -= keep;
+    }
+
+    status = parser_feed_end(p, status);
+    r->status = status;
+    if (status != PARSE_SYNTAX_ERROR)
+    {
+        parser_message(p, r->message, sizeof(r->message));
+    }
+    token_array_free(&tokens);
+    free(buf);
+    return status;
+}
+
+int run_stream(int argc, char *argv[])
+{
+    int verbosity = TRACE_QUIET;
+    size_t chunk = STREAM_CHUNK;
+    const char *path = NULL;
+    const char *stats_path = NULL;
+    for (int i = 0; i < argc; i++)
+    {
+        if (strcmp(argv[i], "-q") == 0)
+        {
+            verbosity = TRACE_QUIET;
+        }
+        else if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+        {
+            // Aceita 0 a 3, mas sem o trace completo, que mostra a entrada restante
+            char *end;
+            long level = strtol(argv[++i], &end, 10);
+            if (end == argv[i] || *end != '\0' || level < TRACE_QUIET || level > TRACE_FULL)
+            {
+                printf("Uso: --stream [-q | -v nivel] [-b bytes] [-m metricas.json] [arquivo | -]\n");
+                return 1;
+            }
+            verbosity = level > TRACE_MATCHES ? TRACE_MATCHES : (int)level;
+        }
+        else if (strcmp(argv[i], "-b") == 0 && i + 1 < argc)
+        {
+            long bytes = atol(argv[++i]);
+            chunk = bytes > 0 ? (size_t)bytes : STREAM_CHUNK;
+        }
+        else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+        {
+            stats_path = argv[++i];
+        }
+        else if (path == NULL)
+        {
+            path = argv[i];
+        }
+        else
+        {
+            printf("Uso: --stream [-q | -v nivel] [-b bytes] [-m metricas.json] [arquivo | -]\n");
+            return 1;
+        }
+    }
+
+    int fd = STDIN_FILENO;
+    if (path != NULL && strcmp(path, "-") != 0 && (fd = open(path, O_RDONLY)) < 0)
+    {
+        perror("Erro ao abrir o arquivo");
+        return 1;
+    }
+    Parser *parser = parser_create();
+    if (parser == NULL)
+    {
+        printf("Erro: Falha ao alocar memória!\n");
+        return 1;
+    }
+    parser_set_verbosity(parser, verbosity);
+    StreamResult result;
+    ParseStatus status = parse_stream(parser, fd, chunk, &result);
+    if (result.read_error != 0)
+    {
+        fprintf(stderr, "Erro ao ler a entrada: %s\n", strerror(result.read_error));
+    }
+    if (stats_path != NULL && parser_stats_save(parser_stats(parser), stats_path) != 0)
+    {
+        perror("Erro ao gravar as métricas");
+    }
+    parser_destroy(parser);
+    if (fd != STDIN_FILENO)
+    {
+        close(fd);
+    }
+
+    if (result.read_error != 0 || status == PARSE_OUT_OF_MEMORY || status == PARSE_NO_END_MARKER)
+    {
+        return 1;
+    }
+    return status == PARSE_ACCEPTED ? 0 : 2;
+}
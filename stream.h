@@ -0,0 +1,31 @@
+#ifndef STREAM_H
+#define STREAM_H
+
+#include "parser.h"
+
+// Modo fluxo: lê a entrada de um descritor (arquivo, pipe, stdin) em blocos
+// de tamanho fixo, passa cada bloco pelo lexer e entrega os tokens ao parser
+// um de cada vez (parser_feed). O arquivo nunca fica inteiro em memória: o
+// uso depende da profundidade da pilha e do bloco, não do tamanho da entrada.
+#define STREAM_CHUNK (64 * 1024)
+
+typedef struct
+{
+    ParseStatus status;
+    uint64_t tokens;  // tokens consumidos pelo parser
+    uint64_t bytes;   // bytes lidos
+    uint64_t offset;  // posição no fluxo do token em que a análise terminou
+    int read_error;   // errno de uma falha de leitura, ou 0
+    char message[256];
+} StreamResult;
+
+// Analisa o conteúdo de fd até o fim, com blocos de chunk bytes (0 usa
+// STREAM_CHUNK). Um token partido entre dois blocos (':=', '<=', '<>', um
+// identificador) é analisado inteiro: o lexema que toca o fim do bloco é
+// guardado e lido de novo com o bloco seguinte.
+ParseStatus parse_stream(Parser *p, int fd, size_t chunk, StreamResult *r);
+
+// argv contém as opções após "--stream": [-q | -v nivel] [-b bytes] [-m metricas.json] [arquivo]
+int run_stream(int argc, char *argv[]);
+
+#endif
@@ -0,0 +1,133 @@
+#include "symtab.h"
+#include "arena.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define SYMTAB_INITIAL_SLOTS 256
+
+// FNV-1a de 32 bits
+static uint32_t hash_name(const char *name, uint32_t len)
+{
+    uint32_t h = 2166136261u;
+    for (uint32_t i = 0; i < len; i++)
+    {
+        h ^= (unsigned char)name[i];
+        h *= 16777619u;
+    }
+    return h;
+}
+
+void symtab_init(SymbolTable *tab)
+{
+    memset(tab, 0, sizeof(*tab));
+}
+
+static uint32_t *find_slot(const SymbolTable *tab, const char *name, uint32_t len, uint32_t h)
+{
+    uint32_t mask = tab->num_slots - 1;
+    for (uint32_t i = h & mask;; i = (i + 1) & mask)
+    {
+        uint32_t id = tab->slots[i];
+        if (id == 0 || (tab->hashes[id - 1] == h && tab->lengths[id - 1] == len &&
+                        memcmp(tab->names[id - 1], name, len) == 0))
+        {
+            return &tab->slots[i];
+        }
+    }
+}
+
+// Dobra o número de posições e reinsere os IDs (a ocupação fica abaixo de 1/2)
+static int grow_slots(SymbolTable *tab)
+{
+    uint32_t num_slots = tab->num_slots ? tab->num_slots * 2 : SYMTAB_INITIAL_SLOTS;
+    uint32_t *slots = counted_malloc(num_slots * sizeof(uint32_t));
+    if (slots == NULL)
+    {
+        return -1;
+    }
+    memset(slots, 0, num_slots * sizeof(uint32_t));
+    free(tab->slots);
+    tab->slots = slots;
+    tab->num_slots = num_slots;
+    for (uint32_t id = 0; id < tab->count; id++)
+    {
+        *find_slot(tab, tab->names[id], tab->lengths[id], tab->hashes[id]) = id + 1;
+    }
+    return 0;
+}
+
+static int grow_entries(SymbolTable *tab)
+{
+    uint32_t capacity = tab->capacity ? tab->capacity * 2 : SYMTAB_INITIAL_SLOTS / 2;
+    const char **names = counted_realloc(tab->names, capacity * sizeof(char *));
+    if (names == NULL)
+    {
+        return -1;
+    }
+    tab->names = names;
+    uint32_t *lengths = counted_realloc(tab->lengths, capacity * sizeof(uint32_t));
+    if (lengths == NULL)
+    {
+        return -1;
+    }
+    tab->lengths = lengths;
+    uint32_t *hashes = counted_realloc(tab->hashes, capacity * sizeof(uint32_t));
+    if (hashes == NULL)
+    {
+        return -1;
+    }
+    tab->hashes = hashes;
+    tab->capacity = capacity;
+    return 0;
+}
+
+// Retorna o ID do nome, criando-o se for novo, ou SYMTAB_NONE se faltar memória
+uint32_t symtab_intern(SymbolTable *tab, const char *name, uint32_t len)
+{
+    if ((tab->count + 1) * 2 > tab->num_slots && grow_slots(tab) != 0)
+    {
+        return SYMTAB_NONE;
+    }
+    uint32_t h = hash_name(name, len);
+    uint32_t *slot = find_slot(tab, name, len, h);
+    if (*slot != 0)
+    {
+        return *slot - 1;
+    }
+    if (tab->count == tab->capacity && grow_entries(tab) != 0)
+    {
+        return SYMTAB_NONE;
+    }
+    uint32_t id = tab->count++;
+    tab->names[id] = name;
+    tab->lengths[id] = len;
+    tab->hashes[id] = h;
+    *slot = id + 1;
+    return id;
+}
+
+// Retorna o ID do nome ou SYMTAB_NONE se ele nunca foi internado
+uint32_t symtab_find(const SymbolTable *tab, const char *name, uint32_t len)
+{
+    if (tab->num_slots == 0)
+    {
+        return SYMTAB_NONE;
+    }
+    uint32_t id = *find_slot(tab, name, len, hash_name(name, len));
+    return id ? id - 1 : SYMTAB_NONE;
+}
+
+const char *symtab_name(const SymbolTable *tab, uint32_t id, uint32_t *len)
+{
+    *len = tab->lengths[id];
+    return tab->names[id];
+}
+
+void symtab_free(SymbolTable *tab)
+{
+    free(tab->names);
+    free(tab->lengths);
+    free(tab->hashes);
+    free(tab->slots);
+    memset(tab, 0, sizeof(*tab));
+}
@@ -0,0 +1,30 @@
+#ifndef SYMTAB_H
+#define SYMTAB_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Tabela de identificadores internados: cada nome distinto recebe um ID denso
+// (0, 1, 2, ...), e o mesmo nome devolve sempre o mesmo ID. Os nomes não são
+// copiados; apontam para o fonte, que precisa continuar válido.
+typedef struct
+{
+    const char **names;
+    uint32_t *lengths;
+    uint32_t *hashes;
+    uint32_t count;
+    uint32_t capacity; // de names/lengths/hashes
+
+    uint32_t *slots; // ID + 1 ou 0 (vazio); endereçamento aberto
+    uint32_t num_slots; // potência de 2
+} SymbolTable;
+
+#define SYMTAB_NONE UINT32_MAX
+
+void symtab_init(SymbolTable *tab);
+uint32_t symtab_intern(SymbolTable *tab, const char *name, uint32_t len);
+uint32_t symtab_find(const SymbolTable *tab, const char *name, uint32_t len);
+const char *symtab_name(const SymbolTable *tab, uint32_t id, uint32_t *len);
+void symtab_free(SymbolTable *tab);
+
+#endif
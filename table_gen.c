@@ -0,0 +1,412 @@
+// Gerado por gen_table a partir de grammar.txt. Não editar.
+#include "parser.h"
+
+_Static_assert(MAX_TERMINALS == 27, "grammar.txt e parser.h divergem");
+_Static_assert(MAX_NONTERMINALS == 28, "grammar.txt e parser.h divergem");
+_Static_assert(MAX_PRODUCTIONS >= 58, "grammar.txt e parser.h divergem");
+
+const uint32_t grammar_version = 0xa51c1834u;
+
+const char *const terminals[MAX_TERMINALS] = {
+    "def", "int", "id", "num", "if", "else", "return", "print",
+    "{", "}", "(", ")", ",", ";", ":=", "<",
+    "<=", ">", ">=", "=", "<>", "==", "+", "-",
+    "*", "/", "$",
+};
+
+const char *const nonTerminals[MAX_NONTERMINALS] = {
+    "S", "MAIN", "FLIST", "FLISTP", "FDEF", "PARLIST", "PARLISTP", "VARLIST",
+    "VARLISTP", "STMT", "ATRIBST", "PRINTST", "RETURNST", "RETURNSTP", "IFSTMT", "IFSTMTTAIL",
+    "STMTLIST", "STMTLISTP", "EXPR", "EXPRP", "NUMEXPR", "NUMEXPRP", "TERM", "TERMP",
+    "FACTOR", "FACTORP", "PARLISTCALL", "PARLISTCALLP",
+};
+
+const symbol_t prod_symbols[] = {
+    28, 36, 29, 30, 31, 30, 31, 9, 43, 8, 11, 32, 10, 2, 0, 33,
+    2, 1, 33, 2, 1, 12, 35, 2, 35, 2, 12, 13, 34, 1, 13, 37,
+    13, 38, 13, 39, 41, 9, 43, 8, 13, 45, 14, 2, 45, 7, 40, 6,
+    2, 42, 36, 11, 45, 10, 4, 36, 5, 44, 36, 44, 36, 46, 47, 47,
+    15, 47, 16, 47, 17, 47, 18, 47, 21, 47, 20, 48, 49, 48, 49, 22,
+    48, 49, 23, 50, 51, 50, 51, 24, 50, 51, 25, 3, 11, 47, 10, 52,
+    2, 11, 53, 10, 54, 2, 54, 2, 12,
+};
+
+const int num_productions = 58;
+
+const Production productions[MAX_PRODUCTIONS] = {
+    {0, 1, N_S, "MAIN"},
+    {1, 1, N_MAIN, "STMT"},
+    {2, 1, N_MAIN, "FLIST"},
+    {3, 0, N_MAIN, ""},
+    {3, 2, N_FLIST, "FDEF FLISTP"},
+    {5, 2, N_FLISTP, "FDEF FLISTP"},
+    {7, 0, N_FLISTP, ""},
+    {7, 8, N_FDEF, "def id ( PARLIST ) { STMTLIST }"},
+    {15, 3, N_PARLIST, "int id PARLISTP"},
+    {18, 0, N_PARLIST, ""},
+    {18, 4, N_PARLISTP, ", int id PARLISTP"},
+    {22, 0, N_PARLISTP, ""},
+    {22, 2, N_VARLIST, "id VARLISTP"},
+    {24, 3, N_VARLISTP, ", id VARLISTP"},
+    {27, 0, N_VARLISTP, ""},
+    {27, 3, N_STMT, "int VARLIST ;"},
+    {30, 2, N_STMT, "ATRIBST ;"},
+    {32, 2, N_STMT, "PRINTST ;"},
+    {34, 2, N_STMT, "RETURNST ;"},
+    {36, 1, N_STMT, "IFSTMT"},
+    {37, 3, N_STMT, "{ STMTLIST }"},
+    {40, 1, N_STMT, ";"},
+    {41, 3, N_ATRIBST, "id := EXPR"},
+    {44, 2, N_PRINTST, "print EXPR"},
+    {46, 2, N_RETURNST, "return RETURNSTP"},
+    {48, 1, N_RETURNSTP, "id"},
+    {49, 0, N_RETURNSTP, ""},
+    {49, 6, N_IFSTMT, "if ( EXPR ) STMT IFSTMTTAIL"},
+    {55, 2, N_IFSTMTTAIL, "else STMT"},
+    {57, 0, N_IFSTMTTAIL, ""},
+    {57, 2, N_STMTLIST, "STMT STMTLISTP"},
+    {59, 2, N_STMTLISTP, "STMT STMTLISTP"},
+    {61, 0, N_STMTLISTP, ""},
+    {61, 2, N_EXPR, "NUMEXPR EXPRP"},
+    {63, 2, N_EXPRP, "< NUMEXPR"},
+    {65, 2, N_EXPRP, "<= NUMEXPR"},
+    {67, 2, N_EXPRP, "> NUMEXPR"},
+    {69, 2, N_EXPRP, ">= NUMEXPR"},
+    {71, 2, N_EXPRP, "== NUMEXPR"},
+    {73, 2, N_EXPRP, "<> NUMEXPR"},
+    {75, 0, N_EXPRP, ""},
+    {75, 2, N_NUMEXPR, "TERM NUMEXPRP"},
+    {77, 3, N_NUMEXPRP, "+ TERM NUMEXPRP"},
+    {80, 3, N_NUMEXPRP, "- TERM NUMEXPRP"},
+    {83, 0, N_NUMEXPRP, ""},
+    {83, 2, N_TERM, "FACTOR TERMP"},
+    {85, 3, N_TERMP, "* FACTOR TERMP"},
+    {88, 3, N_TERMP, "/ FACTOR TERMP"},
+    {91, 0, N_TERMP, ""},
+    {91, 1, N_FACTOR, "num"},
+    {92, 3, N_FACTOR, "( NUMEXPR )"},
+    {95, 2, N_FACTOR, "id FACTORP"},
+    {97, 3, N_FACTORP, "( PARLISTCALL )"},
+    {100, 0, N_FACTORP, ""},
+    {100, 2, N_PARLISTCALL, "id PARLISTCALLP"},
+    {102, 0, N_PARLISTCALL, ""},
+    {102, 3, N_PARLISTCALLP, ", id PARLISTCALLP"},
+    {105, 0, N_PARLISTCALLP, ""},
+};
+
+// prod_table[não-terminal][terminal] = produção, ou NO_PRODUCTION (255)
+const uint8_t prod_table[MAX_NONTERMINALS][MAX_TERMINALS] = {
+    /* S            */ {  0,  0,  0,255,  0,255,  0,  0,  0,255,255,255,255,  0,255,255,255,255,255,255,255,255,255,255,255,255,  0},
+    /* MAIN         */ {  2,  1,  1,255,  1,255,  1,  1,  1,255,255,255,255,  1,255,255,255,255,255,255,255,255,255,255,255,255,  3},
+    /* FLIST        */ {  4,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* FLISTP       */ {  5,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,  6},
+    /* FDEF         */ {  7,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* PARLIST      */ {255,  8,255,255,255,255,255,255,255,255,255,  9,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* PARLISTP     */ {255,255,255,255,255,255,255,255,255,255,255, 11, 10,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* VARLIST      */ {255,255, 12,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* VARLISTP     */ {255,255,255,255,255,255,255,255,255,255,255,255, 13, 14,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* STMT         */ {255, 15, 16,255, 19,255, 18, 17, 20,255,255,255,255, 21,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* ATRIBST      */ {255,255, 22,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* PRINTST      */ {255,255,255,255,255,255,255, 23,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* RETURNST     */ {255,255,255,255,255,255, 24,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* RETURNSTP    */ {255,255, 25,255,255,255,255,255,255,255,255,255,255, 26,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* IFSTMT       */ {255,255,255,255, 27,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* IFSTMTTAIL   */ {255, 29, 29,255, 29, 28, 29, 29, 29, 29,255,255,255, 29,255,255,255,255,255,255,255,255,255,255,255,255, 29},
+    /* STMTLIST     */ {255, 30, 30,255, 30,255, 30, 30, 30,255,255,255,255, 30,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* STMTLISTP    */ {255, 31, 31,255, 31,255, 31, 31, 31, 32,255,255,255, 31,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* EXPR         */ {255,255, 33, 33,255,255,255,255,255,255, 33,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* EXPRP        */ {255,255,255,255,255,255,255,255,255,255,255, 40,255, 40,255, 34, 35, 36, 37,255, 39, 38,255,255,255,255,255},
+    /* NUMEXPR      */ {255,255, 41, 41,255,255,255,255,255,255, 41,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* NUMEXPRP     */ {255,255,255,255,255,255,255,255,255,255,255, 44,255, 44,255, 44, 44, 44, 44,255, 44, 44, 42, 43,255,255,255},
+    /* TERM         */ {255,255, 45, 45,255,255,255,255,255,255, 45,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* TERMP        */ {255,255,255,255,255,255,255,255,255,255,255, 48,255, 48,255, 48, 48, 48, 48,255, 48, 48, 48, 48, 46, 47,255},
+    /* FACTOR       */ {255,255, 51, 49,255,255,255,255,255,255, 50,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* FACTORP      */ {255,255,255,255,255,255,255,255,255,255, 52, 53,255, 53,255, 53, 53, 53, 53,255, 53, 53, 53, 53, 53, 53,255},
+    /* PARLISTCALL  */ {255,255, 54,255,255,255,255,255,255,255,255, 55,255,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+    /* PARLISTCALLP */ {255,255,255,255,255,255,255,255,255,255,255, 57, 56,255,255,255,255,255,255,255,255,255,255,255,255,255,255},
+};
+
+// follow_set[não-terminal] = FOLLOW, bit t para o terminal t
+const uint32_t follow_set[MAX_NONTERMINALS] = {
+    /* S            */ 0x04000000u, // $
+    /* MAIN         */ 0x04000000u, // $
+    /* FLIST        */ 0x04000000u, // $
+    /* FLISTP       */ 0x04000000u, // $
+    /* FDEF         */ 0x04000001u, // def $
+    /* PARLIST      */ 0x00000800u, // )
+    /* PARLISTP     */ 0x00000800u, // )
+    /* VARLIST      */ 0x00002000u, // ;
+    /* VARLISTP     */ 0x00002000u, // ;
+    /* STMT         */ 0x040023f6u, // int id if else return print { } ; $
+    /* ATRIBST      */ 0x00002000u, // ;
+    /* PRINTST      */ 0x00002000u, // ;
+    /* RETURNST     */ 0x00002000u, // ;
+    /* RETURNSTP    */ 0x00002000u, // ;
+    /* IFSTMT       */ 0x040023f6u, // int id if else return print { } ; $
+    /* IFSTMTTAIL   */ 0x040023f6u, // int id if else return print { } ; $
+    /* STMTLIST     */ 0x00000200u, // }
+    /* STMTLISTP    */ 0x00000200u, // }
+    /* EXPR         */ 0x00002800u, // ) ;
+    /* EXPRP        */ 0x00002800u, // ) ;
+    /* NUMEXPR      */ 0x0037a800u, // ) ; < <= > >= <> ==
+    /* NUMEXPRP     */ 0x0037a800u, // ) ; < <= > >= <> ==
+    /* TERM         */ 0x00f7a800u, // ) ; < <= > >= <> == + -
+    /* TERMP        */ 0x00f7a800u, // ) ; < <= > >= <> == + -
+    /* FACTOR       */ 0x03f7a800u, // ) ; < <= > >= <> == + - * /
+    /* FACTORP      */ 0x03f7a800u, // ) ; < <= > >= <> == + - * /
+    /* PARLISTCALL  */ 0x00000800u, // )
+    /* PARLISTCALLP */ 0x00000800u, // )
+};
+
+// chain_table[não-terminal][terminal] = cadeia (válida onde prod_table tem produção)
+const uint16_t chain_table[MAX_NONTERMINALS][MAX_TERMINALS] = {
+    /* S            */ {  0,  1,  2,  0,  3,  0,  4,  5,  6,  0,  0,  0,  0,  7,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  8},
+    /* MAIN         */ {  9, 10, 11,  0, 12,  0, 13, 14, 15,  0,  0,  0,  0, 16,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 17},
+    /* FLIST        */ { 18,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* FLISTP       */ { 19,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 20},
+    /* FDEF         */ { 21,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* PARLIST      */ {  0, 22,  0,  0,  0,  0,  0,  0,  0,  0,  0, 23,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* PARLISTP     */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 24, 25,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* VARLIST      */ {  0,  0, 26,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* VARLISTP     */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 27, 28,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* STMT         */ {  0, 29, 30,  0, 31,  0, 32, 33, 34,  0,  0,  0,  0, 35,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* ATRIBST      */ {  0,  0, 36,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* PRINTST      */ {  0,  0,  0,  0,  0,  0,  0, 37,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* RETURNST     */ {  0,  0,  0,  0,  0,  0, 38,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* RETURNSTP    */ {  0,  0, 39,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 40,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* IFSTMT       */ {  0,  0,  0,  0, 41,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* IFSTMTTAIL   */ {  0, 42, 43,  0, 44, 45, 46, 47, 48, 49,  0,  0,  0, 50,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 51},
+    /* STMTLIST     */ {  0, 52, 53,  0, 54,  0, 55, 56, 57,  0,  0,  0,  0, 58,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* STMTLISTP    */ {  0, 59, 60,  0, 61,  0, 62, 63, 64, 65,  0,  0,  0, 66,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* EXPR         */ {  0,  0, 67, 68,  0,  0,  0,  0,  0,  0, 69,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* EXPRP        */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 70,  0, 71,  0, 72, 73, 74, 75,  0, 76, 77,  0,  0,  0,  0,  0},
+    /* NUMEXPR      */ {  0,  0, 78, 79,  0,  0,  0,  0,  0,  0, 80,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* NUMEXPRP     */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 81,  0, 82,  0, 83, 84, 85, 86,  0, 87, 88, 89, 90,  0,  0,  0},
+    /* TERM         */ {  0,  0, 91, 92,  0,  0,  0,  0,  0,  0, 93,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* TERMP        */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 94,  0, 95,  0, 96, 97, 98, 99,  0,100,101,102,103,104,105,  0},
+    /* FACTOR       */ {  0,  0,106,107,  0,  0,  0,  0,  0,  0,108,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* FACTORP      */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,109,110,  0,111,  0,112,113,114,115,  0,116,117,118,119,120,121,  0},
+    /* PARLISTCALL  */ {  0,  0,122,  0,  0,  0,  0,  0,  0,  0,  0,123,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+    /* PARLISTCALLP */ {  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,124,125,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0},
+};
+
+const Chain chains[] = {
+    {0, 8, 0, 4, 1}, // 0 > 2 > 4 > 7
+    {8, 2, 4, 3, 1}, // 0 > 1 > 15
+    {10, 3, 7, 4, 1}, // 0 > 1 > 16 > 22
+    {13, 5, 11, 4, 1}, // 0 > 1 > 19 > 27
+    {18, 2, 15, 4, 1}, // 0 > 1 > 18 > 24
+    {20, 2, 19, 4, 1}, // 0 > 1 > 17 > 23
+    {22, 2, 23, 3, 1}, // 0 > 1 > 20
+    {24, 0, 26, 3, 1}, // 0 > 1 > 21
+    {24, 0, 29, 2, 0}, // 0 > 3
+    {24, 8, 31, 3, 1}, // 2 > 4 > 7
+    {32, 2, 34, 2, 1}, // 1 > 15
+    {34, 3, 36, 3, 1}, // 1 > 16 > 22
+    {37, 5, 39, 3, 1}, // 1 > 19 > 27
+    {42, 2, 42, 3, 1}, // 1 > 18 > 24
+    {44, 2, 45, 3, 1}, // 1 > 17 > 23
+    {46, 2, 48, 2, 1}, // 1 > 20
+    {48, 0, 50, 2, 1}, // 1 > 21
+    {48, 0, 52, 1, 0}, // 3
+    {48, 8, 53, 2, 1}, // 4 > 7
+    {56, 8, 55, 2, 1}, // 5 > 7
+    {64, 0, 57, 1, 0}, // 6
+    {64, 7, 58, 1, 1}, // 7
+    {71, 2, 59, 1, 1}, // 8
+    {73, 0, 60, 1, 0}, // 9
+    {73, 0, 61, 1, 0}, // 11
+    {73, 3, 62, 1, 1}, // 10
+    {76, 1, 63, 1, 1}, // 12
+    {77, 2, 64, 1, 1}, // 13
+    {79, 0, 65, 1, 0}, // 14
+    {79, 2, 66, 1, 1}, // 15
+    {81, 3, 67, 2, 1}, // 16 > 22
+    {84, 5, 69, 2, 1}, // 19 > 27
+    {89, 2, 71, 2, 1}, // 18 > 24
+    {91, 2, 73, 2, 1}, // 17 > 23
+    {93, 2, 75, 1, 1}, // 20
+    {95, 0, 76, 1, 1}, // 21
+    {95, 2, 77, 1, 1}, // 22
+    {97, 1, 78, 1, 1}, // 23
+    {98, 1, 79, 1, 1}, // 24
+    {99, 0, 80, 1, 1}, // 25
+    {99, 0, 81, 1, 0}, // 26
+    {99, 5, 82, 1, 1}, // 27
+    {104, 0, 83, 1, 0}, // 29
+    {104, 0, 84, 1, 0}, // 29
+    {104, 0, 85, 1, 0}, // 29
+    {104, 1, 86, 1, 1}, // 28
+    {105, 0, 87, 1, 0}, // 29
+    {105, 0, 88, 1, 0}, // 29
+    {105, 0, 89, 1, 0}, // 29
+    {105, 0, 90, 1, 0}, // 29
+    {105, 0, 91, 1, 0}, // 29
+    {105, 0, 92, 1, 0}, // 29
+    {105, 3, 93, 2, 1}, // 30 > 15
+    {108, 4, 95, 3, 1}, // 30 > 16 > 22
+    {112, 6, 98, 3, 1}, // 30 > 19 > 27
+    {118, 3, 101, 3, 1}, // 30 > 18 > 24
+    {121, 3, 104, 3, 1}, // 30 > 17 > 23
+    {124, 3, 107, 2, 1}, // 30 > 20
+    {127, 1, 109, 2, 1}, // 30 > 21
+    {128, 3, 111, 2, 1}, // 31 > 15
+    {131, 4, 113, 3, 1}, // 31 > 16 > 22
+    {135, 6, 116, 3, 1}, // 31 > 19 > 27
+    {141, 3, 119, 3, 1}, // 31 > 18 > 24
+    {144, 3, 122, 3, 1}, // 31 > 17 > 23
+    {147, 3, 125, 2, 1}, // 31 > 20
+    {150, 0, 127, 1, 0}, // 32
+    {150, 1, 128, 2, 1}, // 31 > 21
+    {151, 4, 130, 4, 1}, // 33 > 41 > 45 > 51
+    {155, 3, 134, 4, 1}, // 33 > 41 > 45 > 49
+    {158, 5, 138, 4, 1}, // 33 > 41 > 45 > 50
+    {163, 0, 142, 1, 0}, // 40
+    {163, 0, 143, 1, 0}, // 40
+    {163, 1, 144, 1, 1}, // 34
+    {164, 1, 145, 1, 1}, // 35
+    {165, 1, 146, 1, 1}, // 36
+    {166, 1, 147, 1, 1}, // 37
+    {167, 1, 148, 1, 1}, // 39
+    {168, 1, 149, 1, 1}, // 38
+    {169, 3, 150, 3, 1}, // 41 > 45 > 51
+    {172, 2, 153, 3, 1}, // 41 > 45 > 49
+    {174, 4, 156, 3, 1}, // 41 > 45 > 50
+    {178, 0, 159, 1, 0}, // 44
+    {178, 0, 160, 1, 0}, // 44
+    {178, 0, 161, 1, 0}, // 44
+    {178, 0, 162, 1, 0}, // 44
+    {178, 0, 163, 1, 0}, // 44
+    {178, 0, 164, 1, 0}, // 44
+    {178, 0, 165, 1, 0}, // 44
+    {178, 0, 166, 1, 0}, // 44
+    {178, 2, 167, 1, 1}, // 42
+    {180, 2, 168, 1, 1}, // 43
+    {182, 2, 169, 2, 1}, // 45 > 51
+    {184, 1, 171, 2, 1}, // 45 > 49
+    {185, 3, 173, 2, 1}, // 45 > 50
+    {188, 0, 175, 1, 0}, // 48
+    {188, 0, 176, 1, 0}, // 48
+    {188, 0, 177, 1, 0}, // 48
+    {188, 0, 178, 1, 0}, // 48
+    {188, 0, 179, 1, 0}, // 48
+    {188, 0, 180, 1, 0}, // 48
+    {188, 0, 181, 1, 0}, // 48
+    {188, 0, 182, 1, 0}, // 48
+    {188, 0, 183, 1, 0}, // 48
+    {188, 0, 184, 1, 0}, // 48
+    {188, 2, 185, 1, 1}, // 46
+    {190, 2, 186, 1, 1}, // 47
+    {192, 1, 187, 1, 1}, // 51
+    {193, 0, 188, 1, 1}, // 49
+    {193, 2, 189, 1, 1}, // 50
+    {195, 2, 190, 1, 1}, // 52
+    {197, 0, 191, 1, 0}, // 53
+    {197, 0, 192, 1, 0}, // 53
+    {197, 0, 193, 1, 0}, // 53
+    {197, 0, 194, 1, 0}, // 53
+    {197, 0, 195, 1, 0}, // 53
+    {197, 0, 196, 1, 0}, // 53
+    {197, 0, 197, 1, 0}, // 53
+    {197, 0, 198, 1, 0}, // 53
+    {197, 0, 199, 1, 0}, // 53
+    {197, 0, 200, 1, 0}, // 53
+    {197, 0, 201, 1, 0}, // 53
+    {197, 0, 202, 1, 0}, // 53
+    {197, 1, 203, 1, 1}, // 54
+    {198, 0, 204, 1, 0}, // 55
+    {198, 0, 205, 1, 0}, // 57
+    {198, 2, 206, 1, 1}, // 56
+};
+
+const symbol_t chain_symbols[] = {
+    30, 9, 43, 8, 11, 32, 10, 2, 13, 34, 13, 45, 14, 42, 36, 11,
+    45, 10, 13, 40, 13, 45, 9, 43, 30, 9, 43, 8, 11, 32, 10, 2,
+    13, 34, 13, 45, 14, 42, 36, 11, 45, 10, 13, 40, 13, 45, 9, 43,
+    30, 9, 43, 8, 11, 32, 10, 2, 30, 9, 43, 8, 11, 32, 10, 2,
+    9, 43, 8, 11, 32, 10, 2, 33, 2, 33, 2, 1, 35, 35, 2, 13,
+    34, 13, 45, 14, 42, 36, 11, 45, 10, 13, 40, 13, 45, 9, 43, 45,
+    14, 45, 40, 42, 36, 11, 45, 10, 36, 44, 13, 34, 44, 13, 45, 14,
+    44, 42, 36, 11, 45, 10, 44, 13, 40, 44, 13, 45, 44, 9, 43, 44,
+    44, 13, 34, 44, 13, 45, 14, 44, 42, 36, 11, 45, 10, 44, 13, 40,
+    44, 13, 45, 44, 9, 43, 44, 46, 48, 50, 52, 46, 48, 50, 46, 48,
+    50, 11, 47, 47, 47, 47, 47, 47, 47, 48, 50, 52, 48, 50, 48, 50,
+    11, 47, 48, 49, 48, 49, 50, 52, 50, 50, 11, 47, 50, 51, 50, 51,
+    52, 11, 47, 11, 53, 54, 54, 2,
+};
+
+const uint8_t chain_productions[] = {
+    0, 2, 4, 7, 0, 1, 15, 0, 1, 16, 22, 0, 1, 19, 27, 0,
+    1, 18, 24, 0, 1, 17, 23, 0, 1, 20, 0, 1, 21, 0, 3, 2,
+    4, 7, 1, 15, 1, 16, 22, 1, 19, 27, 1, 18, 24, 1, 17, 23,
+    1, 20, 1, 21, 3, 4, 7, 5, 7, 6, 7, 8, 9, 11, 10, 12,
+    13, 14, 15, 16, 22, 19, 27, 18, 24, 17, 23, 20, 21, 22, 23, 24,
+    25, 26, 27, 29, 29, 29, 28, 29, 29, 29, 29, 29, 29, 30, 15, 30,
+    16, 22, 30, 19, 27, 30, 18, 24, 30, 17, 23, 30, 20, 30, 21, 31,
+    15, 31, 16, 22, 31, 19, 27, 31, 18, 24, 31, 17, 23, 31, 20, 32,
+    31, 21, 33, 41, 45, 51, 33, 41, 45, 49, 33, 41, 45, 50, 40, 40,
+    34, 35, 36, 37, 39, 38, 41, 45, 51, 41, 45, 49, 41, 45, 50, 44,
+    44, 44, 44, 44, 44, 44, 44, 42, 43, 45, 51, 45, 49, 45, 50, 48,
+    48, 48, 48, 48, 48, 48, 48, 48, 48, 46, 47, 51, 49, 50, 52, 53,
+    53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 53, 54, 55, 57, 56,
+};
+
+// Hash perfeito dos nomes: h = (len * a + primeiro * b + meio * c + último) & (tamanho - 1)
+static const uint8_t terminal_lookup_slots[128] = {
+    255,   0, 255,  14, 255, 255, 255,  16,  19,  21, 255,  18,  11, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,  20, 255,   4,  17,   3, 255, 255,  24,
+    255, 255,   8, 255, 255, 255, 255, 255,   6,   1, 255, 255, 255,  26, 255, 255,
+    255, 255,  22, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255,  12, 255, 255,   9, 255, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255, 255, 255, 255,  23, 255, 255, 255, 255, 255, 255, 255,
+    255, 255,  13,   5, 255, 255, 255, 255, 255,   7, 255, 255, 255, 255, 255, 255,
+    255, 255, 255, 255, 255,  15, 255, 255,   2,  10, 255, 255, 255, 255,  25, 255,
+};
+
+static const uint8_t terminal_lookup_lengths[27] = {
+    3, 3, 2, 3, 2, 4, 6, 5, 1, 1, 1, 1, 1, 1, 2, 1,
+    2, 1, 2, 1, 2, 2, 1, 1, 1, 1, 1,
+};
+
+int terminal_lookup(const char *s, size_t len)
+{
+    if (len == 0)
+    {
+        return -1;
+    }
+    const unsigned char *u = (const unsigned char *)s;
+    int i = terminal_lookup_slots[(len * 1 + u[0] * 2 + u[len / 2] * 16 + u[len - 1]) & 127];
+    if (i != 0xFF && terminal_lookup_lengths[i] == len && memcmp(terminals[i], s, len) == 0)
+    {
+        return i;
+    }
+    return -1;
+}
+
+static const uint8_t nonterminal_lookup_slots[64] = {
+    255, 255, 255, 255, 255, 255,   2,  17,  16,   4,  14,   8, 255, 255,  15, 255,
+     27, 255, 255,   3, 255, 255, 255,   9, 255, 255, 255,   6, 255,   7,  20,  22,
+     21,  13,  12,  11,  10,  23, 255, 255, 255, 255, 255, 255, 255,   5,  26,   0,
+     24,  25, 255, 255, 255,   1,  18,  19, 255, 255, 255, 255, 255, 255, 255, 255,
+};
+
+static const uint8_t nonterminal_lookup_lengths[28] = {
+    1, 4, 5, 6, 4, 7, 8, 7, 8, 4, 7, 7, 8, 9, 6, 10,
+    8, 9, 4, 5, 7, 8, 4, 5, 6, 7, 11, 12,
+};
+
+int nonterminal_lookup(const char *s, size_t len)
+{
+    if (len == 0)
+    {
+        return -1;
+    }
+    const unsigned char *u = (const unsigned char *)s;
+    int i = nonterminal_lookup_slots[(len * 3 + u[0] * 8 + u[len / 2] * 27 + u[len - 1]) & 63];
+    if (i != 0xFF && nonterminal_lookup_lengths[i] == len && memcmp(nonTerminals[i], s, len) == 0)
+    {
+        return i;
+    }
+    return -1;
+}
+
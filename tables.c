@@ -0,0 +1,575 @@
+#include "tables.h"
+#include "grammar.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Formato do arquivo compilado (na ordem de bytes da máquina, como o cache de
+// resultados): cabeçalho seguido das seções, cada uma alinhada em 8 bytes e
+// já no formato usado pelo parser, exceto produções e nomes, que guardam
+// deslocamentos no lugar de ponteiros
+#define TABLES_MAGIC "P3GT"
+#define TABLES_FORMAT 1
+#define TABLES_SUFFIX ".p3t"
+
+enum
+{
+    SEC_PROD_TABLE,        // uint8_t [num_nonterminals * MAX_TERMINALS]
+    SEC_FOLLOW,            // uint32_t [num_nonterminals]
+    SEC_CHAIN_TABLE,       // uint16_t [num_nonterminals * MAX_TERMINALS]
+    SEC_CHAINS,            // Chain [num_chains]
+    SEC_CHAIN_SYMBOLS,     // symbol_t []
+    SEC_CHAIN_PRODUCTIONS, // uint8_t []
+    SEC_PRODUCTIONS,       // FileProduction [num_productions]
+    SEC_PROD_SYMBOLS,      // symbol_t []
+    SEC_NAMES,             // uint32_t [num_nonterminals], deslocamentos em SEC_STRINGS
+    SEC_STRINGS,           // nomes e textos das produções, terminados em '\0'
+    NUM_SECTIONS
+};
+
+typedef struct
+{
+    uint32_t offset;
+    uint32_t size;
+} Section;
+
+typedef struct
+{
+    char magic[4];
+    uint32_t format;
+    uint32_t grammar_hash; // grammar_hash do texto BNF compilado
+    uint32_t num_nonterminals;
+    uint32_t num_productions;
+    uint32_t num_chains;
+    Section sections[NUM_SECTIONS];
+} TablesHeader;
+
+typedef struct
+{
+    uint16_t offset; // em SEC_PROD_SYMBOLS
+    uint8_t length;
+    uint8_t lhs;
+    uint32_t text;   // em SEC_STRINGS
+} FileProduction;
+
+struct LoadedTables
+{
+    ParseTables tables;
+    unsigned char *data;
+    size_t size;
+    int mapped; // data vem de mmap (senão, de malloc)
+    int from_cache;
+    Production *productions;
+    const char **names;
+};
+
+// Limites do formato dos símbolos: não-terminais em [MAX_TERMINALS, 255) e
+// NO_PRODUCTION (0xFF) reservado na tabela
+#define TABLES_MAX_NONTERMINALS (T_INVALID - MAX_TERMINALS)
+#define TABLES_MAX_PRODUCTIONS NO_PRODUCTION
+
+static const void *section(const LoadedTables *lt, int s)
+{
+    const TablesHeader *h = (const TablesHeader *)lt->data;
+    return lt->data + h->sections[s].offset;
+}
+
+static int all_below(const uint8_t *values, size_t n, unsigned limit, int allowed)
+{
+    for (size_t i = 0; i < n; i++)
+    {
+        if (values[i] >= limit && values[i] != allowed)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Confere o arquivo inteiro antes de usá-lo: um .p3t truncado ou de outra
+// versão não pode levar o parser a ler fora das tabelas
+static int validate(const LoadedTables *lt)
+{
+    if (lt->size < sizeof(TablesHeader))
+    {
+        return 0;
+    }
+    const TablesHeader *h = (const TablesHeader *)lt->data;
+    if (memcmp(h->magic, TABLES_MAGIC, 4) != 0 || h->format != TABLES_FORMAT || h->num_nonterminals == 0 ||
+        h->num_nonterminals > TABLES_MAX_NONTERMINALS || h->num_productions > TABLES_MAX_PRODUCTIONS)
+    {
+        return 0;
+    }
+    for (int s = 0; s < NUM_SECTIONS; s++)
+    {
+        if ((uint64_t)h->sections[s].offset + h->sections[s].size > lt->size || h->sections[s].offset % 8 != 0)
+        {
+            return 0;
+        }
+    }
+
+    size_t nt = h->num_nonterminals, np = h->num_productions, cells = nt * MAX_TERMINALS;
+    const Section *sec = h->sections;
+    if (sec[SEC_PROD_TABLE].size != cells || sec[SEC_FOLLOW].size != nt * sizeof(uint32_t) ||
+        sec[SEC_CHAIN_TABLE].size != cells * sizeof(uint16_t) || sec[SEC_CHAINS].size != h->num_chains * sizeof(Chain) ||
+        sec[SEC_PRODUCTIONS].size != np * sizeof(FileProduction) || sec[SEC_NAMES].size != nt * sizeof(uint32_t) ||
+        sec[SEC_STRINGS].size == 0)
+    {
+        return 0;
+    }
+
+    unsigned num_symbols = MAX_TERMINALS + (unsigned)nt;
+    const char *strings = section(lt, SEC_STRINGS);
+    uint32_t strings_size = sec[SEC_STRINGS].size;
+    if (strings[strings_size - 1] != '\0' ||
+        !all_below(section(lt, SEC_PROD_TABLE), cells, (unsigned)np, NO_PRODUCTION) ||
+        !all_below(section(lt, SEC_CHAIN_SYMBOLS), sec[SEC_CHAIN_SYMBOLS].size, num_symbols, -1) ||
+        !all_below(section(lt, SEC_CHAIN_PRODUCTIONS), sec[SEC_CHAIN_PRODUCTIONS].size, (unsigned)np, -1) ||
+        !all_below(section(lt, SEC_PROD_SYMBOLS), sec[SEC_PROD_SYMBOLS].size, num_symbols, -1))
+    {
+        return 0;
+    }
+
+    const uint16_t *chain_table = section(lt, SEC_CHAIN_TABLE);
+    for (size_t i = 0; i < cells; i++)
+    {
+        if (chain_table[i] >= h->num_chains && ((const uint8_t *)section(lt, SEC_PROD_TABLE))[i] != NO_PRODUCTION)
+        {
+            return 0;
+        }
+    }
+    const Chain *chains = section(lt, SEC_CHAINS);
+    for (size_t i = 0; i < h->num_chains; i++)
+    {
+        if ((uint32_t)chains[i].symbols + chains[i].length > sec[SEC_CHAIN_SYMBOLS].size ||
+            (uint32_t)chains[i].productions + chains[i].steps > sec[SEC_CHAIN_PRODUCTIONS].size)
+        {
+            return 0;
+        }
+    }
+    const FileProduction *productions = section(lt, SEC_PRODUCTIONS);
+    for (size_t i = 0; i < np; i++)
+    {
+        if ((uint32_t)productions[i].offset + productions[i].length > sec[SEC_PROD_SYMBOLS].size ||
+            productions[i].lhs >= nt || productions[i].text >= strings_size)
+        {
+            return 0;
+        }
+    }
+    const uint32_t *names = section(lt, SEC_NAMES);
+    for (size_t i = 0; i < nt; i++)
+    {
+        if (names[i] >= strings_size)
+        {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Monta as ParseTables sobre os dados: as tabelas são usadas no lugar, só as
+// produções e os nomes (com ponteiros) são copiados
+static int attach(LoadedTables *lt)
+{
+    const TablesHeader *h = (const TablesHeader *)lt->data;
+    lt->productions = malloc((h->num_productions ? h->num_productions : 1) * sizeof(Production));
+    lt->names = malloc(h->num_nonterminals * sizeof(char *));
+    if (lt->productions == NULL || lt->names == NULL)
+    {
+        return -1;
+    }
+    const char *strings = section(lt, SEC_STRINGS);
+    const FileProduction *productions = section(lt, SEC_PRODUCTIONS);
+    for (uint32_t i = 0; i < h->num_productions; i++)
+    {
+        lt->productions[i] = (Production){productions[i].offset, productions[i].length, productions[i].lhs,
+                                          strings + productions[i].text};
+    }
+    const uint32_t *names = section(lt, SEC_NAMES);
+    for (uint32_t i = 0; i < h->num_nonterminals; i++)
+    {
+        lt->names[i] = strings + names[i];
+    }
+
+    lt->tables = (ParseTables){
+        (int)h->num_nonterminals,
+        (int)h->num_productions,
+        lt->names,
+        lt->productions,
+        section(lt, SEC_PROD_SYMBOLS),
+        section(lt, SEC_PROD_TABLE),
+        section(lt, SEC_FOLLOW),
+        section(lt, SEC_CHAIN_TABLE),
+        section(lt, SEC_CHAINS),
+        section(lt, SEC_CHAIN_SYMBOLS),
+        section(lt, SEC_CHAIN_PRODUCTIONS),
+    };
+    return 0;
+}
+
+// Mapeia um arquivo inteiro (somente leitura); NULL se não existir ou estiver vazio
+static unsigned char *map_file(const char *path, size_t *size)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return NULL;
+    }
+    struct stat st;
+    void *data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        data = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (data == MAP_FAILED)
+    {
+        return NULL;
+    }
+    *size = (size_t)st.st_size;
+    return data;
+}
+
+// Seções do arquivo em construção, alinhadas em 8 bytes
+static uint32_t layout(TablesHeader *h, int s, size_t size, uint32_t *offset)
+{
+    h->sections[s].offset = *offset;
+    h->sections[s].size = (uint32_t)size;
+    *offset += (uint32_t)((size + 7) & ~(size_t)7);
+    return h->sections[s].offset;
+}
+
+static int symbol_index(const Grammar *g, const int *terminal_map, int symbol)
+{
+    return symbol < g->num_terminals ? terminal_map[symbol] : MAX_TERMINALS + symbol - g->num_terminals;
+}
+
+// Compila a gramática para o formato do arquivo; retorna o buffer (malloc)
+static unsigned char *compile(const char *text, size_t *size, FILE *report)
+{
+    Grammar g;
+    if (grammar_parse(&g, text, report) != 0)
+    {
+        return NULL;
+    }
+    int conflicts = grammar_build_table(&g, report);
+    if (conflicts < 0)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        grammar_free(&g);
+        return NULL;
+    }
+    fprintf(report, "%d terminais, %d não-terminais, %d produções, %d conflito(s) LL(1)\n", g.num_terminals,
+            g.num_nonterminals, g.num_productions, conflicts);
+
+    int nterm = g.num_terminals, nt = g.num_nonterminals, np = g.num_productions;
+    if (nt > TABLES_MAX_NONTERMINALS || np > TABLES_MAX_PRODUCTIONS)
+    {
+        fprintf(report, "Erro: A gramática passa do limite de %d não-terminais e %d produções.\n",
+                TABLES_MAX_NONTERMINALS, TABLES_MAX_PRODUCTIONS);
+        grammar_free(&g);
+        return NULL;
+    }
+    // As colunas da tabela são os tipos de token do lexer
+    int terminal_map[GRAMMAR_MAX_SYMBOLS];
+    for (int t = 0; t < nterm; t++)
+    {
+        terminal_map[t] = terminal_lookup(g.names[t], strlen(g.names[t]));
+        if (terminal_map[t] < 0)
+        {
+            fprintf(report, "Erro: O terminal '%s' não é reconhecido pelo lexer.\n", g.names[t]);
+            grammar_free(&g);
+            return NULL;
+        }
+    }
+    if (terminal_map[g.end_terminal] != T_END)
+    {
+        fprintf(report, "Erro: A gramática não declara o terminal '$'.\n");
+        grammar_free(&g);
+        return NULL;
+    }
+
+    // Tamanhos das seções variáveis
+    size_t num_chains = 0, chain_symbols = 0, chain_steps = 0, prod_symbols = 0, strings = 0;
+    GrammarChain chain;
+    char buf[1024];
+    for (int r = 0; r < nt; r++)
+    {
+        strings += strlen(g.names[nterm + r]) + 1;
+        for (int c = 0; c < nterm; c++)
+        {
+            if (g.table[r * nterm + c] != GRAMMAR_NO_PRODUCTION)
+            {
+                grammar_expand_chain(&g, r, c, &chain);
+                num_chains++;
+                chain_symbols += (size_t)chain.length;
+                chain_steps += (size_t)chain.steps;
+            }
+        }
+    }
+    for (int i = 0; i < np; i++)
+    {
+        prod_symbols += g.productions[i].length;
+        strings += (size_t)grammar_production_text(&g, i, buf, sizeof(buf)) + 1;
+    }
+    if (chain_symbols > UINT16_MAX || chain_steps > UINT16_MAX)
+    {
+        fprintf(report, "Erro: cadeias grandes demais para índices de 16 bits\n");
+        grammar_free(&g);
+        return NULL;
+    }
+
+    TablesHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TABLES_MAGIC, 4);
+    h.format = TABLES_FORMAT;
+    h.grammar_hash = grammar_hash(text);
+    h.num_nonterminals = (uint32_t)nt;
+    h.num_productions = (uint32_t)np;
+    h.num_chains = (uint32_t)num_chains;
+    uint32_t offset = (sizeof(TablesHeader) + 7) & ~7u;
+    size_t cells = (size_t)nt * MAX_TERMINALS;
+    layout(&h, SEC_PROD_TABLE, cells, &offset);
+    layout(&h, SEC_FOLLOW, (size_t)nt * sizeof(uint32_t), &offset);
+    layout(&h, SEC_CHAIN_TABLE, cells * sizeof(uint16_t), &offset);
+    layout(&h, SEC_CHAINS, num_chains * sizeof(Chain), &offset);
+    layout(&h, SEC_CHAIN_SYMBOLS, chain_symbols, &offset);
+    layout(&h, SEC_CHAIN_PRODUCTIONS, chain_steps, &offset);
+    layout(&h, SEC_PRODUCTIONS, (size_t)np * sizeof(FileProduction), &offset);
+    layout(&h, SEC_PROD_SYMBOLS, prod_symbols, &offset);
+    layout(&h, SEC_NAMES, (size_t)nt * sizeof(uint32_t), &offset);
+    layout(&h, SEC_STRINGS, strings, &offset);
+
+    unsigned char *data = calloc(1, offset);
+    if (data == NULL)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        grammar_free(&g);
+        return NULL;
+    }
+    memcpy(data, &h, sizeof(h));
+    uint8_t *prod_table = data + h.sections[SEC_PROD_TABLE].offset;
+    uint32_t *follow = (uint32_t *)(data + h.sections[SEC_FOLLOW].offset);
+    uint16_t *chain_table = (uint16_t *)(data + h.sections[SEC_CHAIN_TABLE].offset);
+    Chain *chains = (Chain *)(data + h.sections[SEC_CHAINS].offset);
+    symbol_t *chain_symbol = data + h.sections[SEC_CHAIN_SYMBOLS].offset;
+    uint8_t *chain_production = data + h.sections[SEC_CHAIN_PRODUCTIONS].offset;
+    FileProduction *productions = (FileProduction *)(data + h.sections[SEC_PRODUCTIONS].offset);
+    symbol_t *prod_symbol = data + h.sections[SEC_PROD_SYMBOLS].offset;
+    uint32_t *names = (uint32_t *)(data + h.sections[SEC_NAMES].offset);
+    char *string = (char *)data + h.sections[SEC_STRINGS].offset;
+    char *string_base = string;
+
+    memset(prod_table, NO_PRODUCTION, cells);
+    size_t index = 0, symbols = 0, steps = 0;
+    for (int r = 0; r < nt; r++)
+    {
+        names[r] = (uint32_t)(string - string_base);
+        string += sprintf(string, "%s", g.names[nterm + r]) + 1;
+        for (int c = 0; c < nterm; c++)
+        {
+            int column = terminal_map[c];
+            if ((g.follow[r * GRAMMAR_SET_WORDS + c / 64] >> (c % 64)) & 1)
+            {
+                follow[r] |= 1u << column;
+            }
+            int production = g.table[r * nterm + c];
+            if (production == GRAMMAR_NO_PRODUCTION)
+            {
+                continue;
+            }
+            prod_table[r * MAX_TERMINALS + column] = (uint8_t)production;
+            grammar_expand_chain(&g, r, c, &chain);
+            chain_table[r * MAX_TERMINALS + column] = (uint16_t)index;
+            chains[index++] = (Chain){(uint16_t)symbols, (uint8_t)chain.length, (uint16_t)steps,
+                                      (uint8_t)chain.steps, (uint8_t)chain.matches};
+            for (int k = chain.length - 1; k >= 0; k--)
+            {
+                chain_symbol[symbols++] = (symbol_t)symbol_index(&g, terminal_map, chain.symbols[k]);
+            }
+            for (int k = 0; k < chain.steps; k++)
+            {
+                chain_production[steps++] = chain.productions[k];
+            }
+        }
+    }
+    symbols = 0;
+    for (int i = 0; i < np; i++)
+    {
+        const GrammarProduction *prod = &g.productions[i];
+        productions[i] = (FileProduction){(uint16_t)symbols, prod->length, prod->lhs,
+                                          (uint32_t)(string - string_base)};
+        for (int k = prod->length - 1; k >= 0; k--)
+        {
+            prod_symbol[symbols++] = (symbol_t)symbol_index(&g, terminal_map, prod->rhs[k]);
+        }
+        grammar_production_text(&g, i, string, sizeof(buf));
+        string += strlen(string) + 1;
+    }
+
+    grammar_free(&g);
+    *size = offset;
+    return data;
+}
+
+// Grava num arquivo temporário e renomeia, como o cache de resultados
+static int save(const char *path, const unsigned char *data, size_t size)
+{
+    size_t n = strlen(path) + 5;
+    char *tmp = malloc(n);
+    if (tmp == NULL)
+    {
+        return -1;
+    }
+    snprintf(tmp, n, "%s.tmp", path);
+    FILE *fp = fopen(tmp, "wb");
+    int ok = fp != NULL && fwrite(data, 1, size, fp) == size;
+    ok = (fp != NULL && fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp, path) != 0)
+    {
+        remove(tmp);
+        free(tmp);
+        return -1;
+    }
+    free(tmp);
+    return 0;
+}
+
+static LoadedTables *finish_load(LoadedTables *lt, FILE *report)
+{
+    if (!validate(lt))
+    {
+        fprintf(report, "Erro: Tabelas compiladas inválidas ou de outra versão.\n");
+        tables_free(lt);
+        return NULL;
+    }
+    if (attach(lt) != 0)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        tables_free(lt);
+        return NULL;
+    }
+    return lt;
+}
+
+LoadedTables *tables_load(const char *path, FILE *report)
+{
+    LoadedTables *lt = calloc(1, sizeof(LoadedTables));
+    if (lt == NULL)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        return NULL;
+    }
+    size_t size = 0;
+    unsigned char *data = map_file(path, &size);
+    if (data == NULL)
+    {
+        fprintf(report, "Erro ao abrir a gramática '%s': %s\n", path, strerror(errno));
+        free(lt);
+        return NULL;
+    }
+
+    // Arquivo já compilado: usado no lugar
+    if (size >= 4 && memcmp(data, TABLES_MAGIC, 4) == 0)
+    {
+        lt->data = data;
+        lt->size = size;
+        lt->mapped = 1;
+        lt->from_cache = 1;
+        return finish_load(lt, report);
+    }
+
+    char *text = malloc(size + 1);
+    if (text == NULL)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        munmap(data, size);
+        free(lt);
+        return NULL;
+    }
+    memcpy(text, data, size);
+    text[size] = '\0';
+    munmap(data, size);
+
+    // Compilação anterior do mesmo texto?
+    size_t n = strlen(path) + sizeof(TABLES_SUFFIX);
+    char *compiled_path = malloc(n);
+    if (compiled_path == NULL)
+    {
+        fprintf(report, "Erro: Falha ao alocar memória!\n");
+        free(text);
+        free(lt);
+        return NULL;
+    }
+    snprintf(compiled_path, n, "%s%s", path, TABLES_SUFFIX);
+    uint32_t hash = grammar_hash(text);
+    data = map_file(compiled_path, &size);
+    if (data != NULL)
+    {
+        lt->data = data;
+        lt->size = size;
+        lt->mapped = 1;
+        if (validate(lt) && ((const TablesHeader *)data)->grammar_hash == hash)
+        {
+            lt->from_cache = 1;
+            free(text);
+            free(compiled_path);
+            return finish_load(lt, report);
+        }
+        munmap(data, size);
+        lt->mapped = 0;
+    }
+
+    lt->data = compile(text, &lt->size, report);
+    free(text);
+    if (lt->data == NULL)
+    {
+        free(compiled_path);
+        free(lt);
+        return NULL;
+    }
+    if (save(compiled_path, lt->data, lt->size) != 0)
+    {
+        fprintf(report, "Aviso: Não foi possível gravar '%s'; a gramática será compilada de novo.\n",
+                compiled_path);
+    }
+    else
+    {
+        fprintf(report, "Tabelas compiladas gravadas em '%s'.\n", compiled_path);
+    }
+    free(compiled_path);
+    return finish_load(lt, report);
+}
+
+const ParseTables *tables_get(const LoadedTables *t)
+{
+    return &t->tables;
+}
+
+int tables_from_cache(const LoadedTables *t)
+{
+    return t->from_cache;
+}
+
+void tables_free(LoadedTables *t)
+{
+    if (t == NULL)
+    {
+        return;
+    }
+    if (t->mapped)
+    {
+        munmap(t->data, t->size);
+    }
+    else
+    {
+        free(t->data);
+    }
+    free(t->productions);
+    free(t->names);
+    free(t);
+}
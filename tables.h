@@ -0,0 +1,26 @@
+#ifndef TABLES_H
+#define TABLES_H
+
+#include "parser.h"
+
+// Gramática carregada em tempo de execução (dialetos sem recompilar o p3).
+// O arquivo BNF tem o formato de grammar.txt; os terminais são os do lexer,
+// em qualquer ordem (um subconjunto basta), e os não-terminais e produções
+// são livres. A compilação (FIRST/FOLLOW, tabela LL(1), conflitos e cadeias)
+// é gravada num arquivo binário versionado ao lado da gramática, que as
+// execuções seguintes mapeiam em memória sem recalcular nada.
+typedef struct LoadedTables LoadedTables;
+
+// Carrega as tabelas de path. Um arquivo compilado (.p3t) é mapeado direto.
+// Um arquivo BNF usa "<path>.p3t" se ele foi compilado do mesmo texto;
+// senão é compilado, com os conflitos relatados em report, e o .p3t é
+// regravado ao lado de path (o caminho é informado em report). Retorna NULL
+// em caso de erro, com a mensagem em report.
+LoadedTables *tables_load(const char *path, FILE *report);
+const ParseTables *tables_get(const LoadedTables *t);
+
+// 1 se as tabelas vieram de um arquivo compilado, 0 se foram calculadas agora
+int tables_from_cache(const LoadedTables *t);
+void tables_free(LoadedTables *t);
+
+#endif
@@ -0,0 +1,10 @@
+#include "writer.h"
+
+void writer_flush(Writer *w)
+{
+    if (w->len > 0)
+    {
+        fwrite(w->buf, 1, w->len, w->fp);
+        w->len = 0;
+    }
+}
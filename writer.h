@@ -0,0 +1,48 @@
+#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <string.h>
+
+// Saída com buffer próprio: acumula o texto e só chama fwrite quando o buffer
+// enche ou em writer_flush, em vez de um printf por linha do trace.
+typedef struct
+{
+    FILE *fp;
+    char *buf;
+    size_t len;
+    size_t cap;
+} Writer;
+
+void writer_flush(Writer *w);
+
+static inline void writer_write(Writer *w, const char *s, size_t n)
+{
+    if (w->len + n > w->cap)
+    {
+        writer_flush(w);
+        if (n > w->cap)
+        {
+            fwrite(s, 1, n, w->fp);
+            return;
+        }
+    }
+    memcpy(w->buf + w->len, s, n);
+    w->len += n;
+}
+
+static inline void writer_puts(Writer *w, const char *s)
+{
+    writer_write(w, s, strlen(s));
+}
+
+static inline void writer_putc(Writer *w, char c)
+{
+    if (w->len == w->cap)
+    {
+        writer_flush(w);
+    }
+    w->buf[w->len++] = c;
+}
+
+#endif